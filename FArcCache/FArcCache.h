@@ -5,67 +5,445 @@
 #ifndef FULINCACHE_FARCCACHE_H
 #define FULINCACHE_FARCCACHE_H
 #include<memory>
+#include <mutex>
+#include <algorithm>
 
-#include "FArcLruPart.h"
-#include "FArcLfuPart.h"
+#include "FArchCacheNode.h"
+#include "../FNodePool.h"
+#include "../FFlatMap.h"
 #include "../FICachePolicy.h"
+#include "../FTimerWheel.h"
 
 
 namespace FulinCache{
+    // ARC (Megiddo & Modha)：T1/T2/B1/B2四条链表的成员关系记录在同一张哈希表的节点标签上，
+    // 每次get/put在一把锁下只做一次哈希查找，p为T1的自适应目标大小。
+    // 访问次数达到transformThreshold后T1中的条目晋升到T2，默认值2即论文中的"第二次命中晋升"。
+    // 给出weigher时各链表大小、p与capacity都按条目权重计，幽灵条目沿用其被淘汰时的权重。
     template<typename Key, typename Value>
     class ArcCache: public FICachePolicy<Key, Value>{
     public:
-        ArcCache(size_t capacity, size_t transformThreshold = 2)
+        using NodeType = FArchCacheNode<Key, Value>;
+        using NodePtr = NodeType*;
+        using NodeMap = FFlatMap<Key, NodeType>;
+        using TimerWheel = FTimerWheel<NodeType>;
+
+        explicit ArcCache(size_t capacity, size_t transformThreshold = 2, FWeigher<Key, Value> weigher = nullptr)
         : capacity_(capacity)
         , transformThreshold_(transformThreshold)
-        , lruPart_(new ArcLruPart<Key, Value>(capacity,transformThreshold))
-        , lfuPart_(new ArcLfuPart<Key, Value>(capacity)){}
+        , p_(0)
+        , weigher_(std::move(weigher)){}
 
-        ~ArcCache()override = default;
+        ~ArcCache()override{
+            nodeMap_.forEach([this](NodePtr node){
+                pool_.deallocate(node);
+            });
+        }
 
-        bool get(Key key, Value& value) override{
-            checkGhostCaches(key);
-            bool shouldTransform = false;
-            if(lruPart_->get(key, value, shouldTransform)){
-                if(shouldTransform)
-                    lfuPart_->put(key, value);
-            }
-            return lfuPart_->get(key, value);
+        bool get(const Key& key, Value& value) override{
+            FLatencyTimer timer(latency_, FCacheOp::Get);
+            std::lock_guard<std::mutex> lock(mutex_);
+            return getLocked(key, value);
+        }
+
+        Value get(const Key& key) override{
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        template<typename K, typename = FEnableTransparent<Key, K>>
+        bool get(const K& key, Value& value){
+            FLatencyTimer timer(latency_, FCacheOp::Get);
+            std::lock_guard<std::mutex> lock(mutex_);
+            return getLocked(key, value);
         }
 
-        Value get(Key key) override{
+        template<typename K, typename = FEnableTransparent<Key, K>>
+        Value get(const K& key){
             Value value{};
             get(key, value);
             return value;
         }
 
-        void put(Key key, Value value) override{
-            checkGhostCaches(key);
-            bool inLfu = lfuPart_->contains(key);
-            lruPart_->put(key,value);
-            if(inLfu)
-                lfuPart_->put(key,value);
+        FValueHandle<Value> getHandle(const Key& key) override{
+            FLatencyTimer timer(latency_, FCacheOp::Get);
+            std::lock_guard<std::mutex> lock(mutex_);
+            NodePtr node = lookupLocked(key);
+            return node ? node->getHandle() : nullptr;
+        }
+
+        void put(const Key& key, const Value& value) override{
+            if(capacity_ == 0) return;
+            FLatencyTimer timer(latency_, FCacheOp::Put);
+            std::lock_guard<std::mutex> lock(mutex_);
+            expireEntries();
+            putLocked(0, key, value);
+        }
+
+        void put(Key key, Value&& value) override{
+            if(capacity_ == 0) return;
+            FLatencyTimer timer(latency_, FCacheOp::Put);
+            std::lock_guard<std::mutex> lock(mutex_);
+            expireEntries();
+            putLocked(0, std::move(key), std::move(value));
+        }
+
+        // 条目在ttl后过期，get时惰性删除，写操作与tick()时由时间轮回收；不带ttl的put会清除过期时间。
+        // 过期的条目直接删除而不降级为幽灵条目，过期不代表访问模式，不应影响p
+        void put(const Key& key, const Value& value, std::chrono::nanoseconds ttl){
+            if(capacity_ == 0) return;
+            FLatencyTimer timer(latency_, FCacheOp::Put);
+            std::lock_guard<std::mutex> lock(mutex_);
+            expireEntries();
+            putLocked(TimerWheel::deadline(ttl), key, value);
+        }
+
+        void put(Key key, Value&& value, std::chrono::nanoseconds ttl){
+            if(capacity_ == 0) return;
+            FLatencyTimer timer(latency_, FCacheOp::Put);
+            std::lock_guard<std::mutex> lock(mutex_);
+            expireEntries();
+            putLocked(TimerWheel::deadline(ttl), std::move(key), std::move(value));
+        }
+
+        // 用args在节点内直接构造value
+        template<typename... Args>
+        void emplace(const Key& key, Args&&... args){
+            if(capacity_ == 0) return;
+            FLatencyTimer timer(latency_, FCacheOp::Put);
+            std::lock_guard<std::mutex> lock(mutex_);
+            expireEntries();
+            putLocked(0, key, std::forward<Args>(args)...);
+        }
+
+        size_t getMany(FSpan<const Key> keys, FSpan<Value> values, FSpan<bool> hits) override{
+            keys = this->batchKeys(keys, values, hits);
+            FLatencyTimer timer(latency_, FCacheOp::Get);
+            std::lock_guard<std::mutex> lock(mutex_);
+            size_t hitCount = 0;
+            for(size_t i = 0; i < keys.size(); ++i){
+                hits[i] = getLocked(keys[i], values[i]);
+                if(hits[i]) hitCount++;
+            }
+            return hitCount;
+        }
+
+        void putMany(FSpan<const Key> keys, FSpan<const Value> values) override{
+            if(capacity_ == 0) return;
+            keys = keys.first(values.size());
+            FLatencyTimer timer(latency_, FCacheOp::Put);
+            std::lock_guard<std::mutex> lock(mutex_);
+            expireEntries();
+            for(size_t i = 0; i < keys.size(); ++i)
+                putLocked(0, keys[i], values[i]);
+        }
+
+        // 回收所有已过期的条目
+        void tick(){
+            std::lock_guard<std::mutex> lock(mutex_);
+            expireEntries();
+        }
+
+        // T1与T2中条目的权重之和，未给weigher时即缓存的条目数
+        size_t weightedSize(){
+            std::lock_guard<std::mutex> lock(mutex_);
+            return residentSize();
+        }
+
+        FCacheStats stats() override{
+            return stats_.snapshot(weightedSize());
+        }
+
+        FLatencyHistogram latency(FCacheOp op) override{
+            FLatencyHistogram histogram;
+            latency_.mergeInto(op, histogram);
+            return histogram;
         }
+
     private:
-        bool checkGhostCaches(Key key){
-            bool inGhost = false;
-            if(lruPart_->checkGhost(key)) {
-                if (lfuPart_->decreaseCapacity())
-                    lruPart_->increaseCapacity();
-                inGhost = true;
+        struct ArcList{
+            ArcList(): size(0){
+                head.next = &tail;
+                tail.prev = &head;
+            }
+            ArcList(const ArcList&) = delete;
+            ArcList& operator=(const ArcList&) = delete;
+
+            NodePtr last(){
+                return tail.prev != &head ? tail.prev : nullptr;
             }
-            else if(lfuPart_->checkGhost(key)) {
-                if (lruPart_->decreaseCapacity())
-                    lfuPart_->increaseCapacity();
-                inGhost = true;
+
+            NodeType head;
+            NodeType tail;
+            size_t size; // 链表中条目的权重之和
+        };
+
+        template<typename K>
+        bool getLocked(const K& key, Value& value){
+            NodePtr node = lookupLocked(key);
+            if(!node)
+                return false;
+            value = node->getValue();
+            return true;
+        }
+
+        // 命中返回节点并更新其位置；幽灵命中只调整p，返回nullptr
+        template<typename K>
+        NodePtr lookupLocked(const K& key){
+            NodePtr node = nodeMap_.find(key);
+            if(!node){
+                stats_.record(FStatsCounter::Miss);
+                return nullptr;
+            }
+            if(node->isGhost()){
+                if(!node->ghostHit){
+                    adaptTarget(node);
+                    node->ghostHit = true;
+                    stats_.record(FStatsCounter::GhostHit);
+                }
+                stats_.record(FStatsCounter::Miss);
+                return nullptr;
+            }
+            if(isExpired(node)){
+                removeEntry(node);
+                stats_.record(FStatsCounter::Expiration);
+                stats_.record(FStatsCounter::Miss);
+                return nullptr;
             }
-            return inGhost;
+            touch(node);
+            stats_.record(FStatsCounter::Hit);
+            return node;
+        }
+
+        // expireAt为0表示不过期
+        template<typename K, typename... Args>
+        void putLocked(uint64_t expireAt, K&& key, Args&&... args){
+            size_t hash = nodeMap_.hash(key);
+            NodePtr node = nodeMap_.find(key, hash);
+            if(node){
+                if(node->isGhost())
+                    reviveGhost(node, expireAt, std::forward<Args>(args)...);
+                else{
+                    node->setValue(std::forward<Args>(args)...);
+                    reweigh(node);
+                    setExpireAt(node, expireAt);
+                    touch(node);
+                    stats_.record(FStatsCounter::Update);
+                    evictResident(0, false);
+                }
+                return;
+            }
+            node = pool_.allocate(std::forward<K>(key), std::forward<Args>(args)...);
+            node->weight = weigh(node);
+            if(node->weight > capacity_){ // 单个条目超出总预算，不缓存
+                pool_.deallocate(node);
+                return;
+            }
+            makeRoomForMiss(node->weight);
+            nodeMap_.insert(node, hash);
+            pushFront(ArcListTag::T1, node);
+            setExpireAt(node, expireAt);
+            stats_.record(FStatsCounter::Put);
+        }
+
+        void setExpireAt(NodePtr node, uint64_t expireAt){
+            node->expireAt = expireAt;
+            if(expireAt){
+                if(!timerWheel_)
+                    timerWheel_.reset(new TimerWheel(TimerWheel::now()));
+                timerWheel_->schedule(node);
+            }else if(timerWheel_){
+                timerWheel_->deschedule(node);
+            }
+        }
+
+        static bool isExpired(NodePtr node){
+            return node->expireAt && node->expireAt <= TimerWheel::now();
+        }
+
+        void expireEntries(){
+            if(!timerWheel_) return;
+            FLatencyTimer timer(latency_, FCacheOp::Maintain);
+            timerWheel_->advance(TimerWheel::now(), [this](NodePtr node){
+                removeEntry(node);
+                stats_.record(FStatsCounter::Expiration);
+            });
+        }
+
+        size_t weigh(NodePtr node) const{
+            return weigher_ ? weigher_(node->getKey(), node->getValue()) : 1;
+        }
+
+        void reweigh(NodePtr node){
+            size_t weight = weigh(node);
+            ArcList& owner = list(node->tag);
+            owner.size = owner.size - node->weight + weight;
+            node->weight = weight;
+        }
+
+        ArcList& list(ArcListTag tag){
+            return lists_[static_cast<size_t>(tag)];
+        }
+
+        size_t listSize(ArcListTag tag){
+            return list(tag).size;
+        }
+
+        size_t residentSize(){
+            return listSize(ArcListTag::T1) + listSize(ArcListTag::T2);
+        }
+
+        void pushFront(ArcListTag tag, NodePtr node){
+            ArcList& target = list(tag);
+            node->next = target.head.next;
+            node->prev = &target.head;
+            target.head.next->prev = node;
+            target.head.next = node;
+            node->tag = tag;
+            target.size += node->weight;
+        }
+
+        void unlink(NodePtr node){
+            node->prev->next = node->next;
+            node->next->prev = node->prev;
+            node->next = nullptr;
+            node->prev = nullptr;
+            list(node->tag).size -= node->weight;
+        }
+
+        // 命中缓存中的条目：T1中访问次数达到阈值则晋升到T2，否则移到所在链表的MRU端
+        void touch(NodePtr node){
+            ArcListTag tag = node->tag;
+            if(tag == ArcListTag::T1){
+                node->incrementAccessCount();
+                if(transformThreshold_ <= node->getAccessCount())
+                    tag = ArcListTag::T2;
+            }
+            unlink(node);
+            pushFront(tag, node);
+        }
+
+        // 论文中p每次移动1或|B2|/|B1|个条目，按权重计时以命中的幽灵条目权重为单位
+        void adaptTarget(NodePtr ghost){
+            size_t b1 = listSize(ArcListTag::B1);
+            size_t b2 = listSize(ArcListTag::B2);
+            size_t unit = ghost->weight;
+            if(ghost->tag == ArcListTag::B1){
+                size_t delta = (b1 == 0 || b1 >= b2) ? unit : unit * (b2 / b1);
+                p_ = std::min(capacity_, p_ + delta);
+            }else{
+                size_t delta = (b2 == 0 || b2 >= b1) ? unit : unit * (b1 / b2);
+                p_ = p_ > delta ? p_ - delta : 0;
+            }
+        }
+
+        // 按论文中的REPLACE反复把T1或T2的条目降级到幽灵链表，直到能放下incoming权重的新条目
+        void evictResident(size_t incoming, bool hitInB2){
+            while(residentSize() > 0 && residentSize() + incoming > capacity_)
+                replace(hitInB2);
+        }
+
+        // 论文中的REPLACE：按目标p从T1或T2淘汰一个条目到对应的幽灵链表
+        void replace(bool hitInB2){
+            size_t t1 = listSize(ArcListTag::T1);
+            if(t1 > 0 && (t1 > p_ || (hitInB2 && t1 == p_)))
+                demote(ArcListTag::T1, ArcListTag::B1);
+            else if(listSize(ArcListTag::T2) > 0)
+                demote(ArcListTag::T2, ArcListTag::B2);
+            else
+                demote(ArcListTag::T1, ArcListTag::B1);
+        }
+
+        void demote(ArcListTag from, ArcListTag to){
+            NodePtr node = list(from).last();
+            if(!node) return;
+            FLatencyTimer timer(latency_, FCacheOp::Evict);
+            unlink(node);
+            setExpireAt(node, 0);
+            node->clearValue(); // 幽灵条目不再持有value
+            stats_.record(FStatsCounter::Eviction);
+            node->accessCount = 1;
+            node->ghostHit = false;
+            pushFront(to, node);
+        }
+
+        void dropLast(ArcListTag tag){
+            NodePtr node = list(tag).last();
+            if(!node) return;
+            if(node->isGhost()){
+                removeEntry(node);
+                return;
+            }
+            FLatencyTimer timer(latency_, FCacheOp::Evict);
+            removeEntry(node);
+            stats_.record(FStatsCounter::Eviction);
+        }
+
+        void removeEntry(NodePtr node){
+            if(timerWheel_)
+                timerWheel_->deschedule(node);
+            unlink(node);
+            nodeMap_.erase(node->getKey());
+            pool_.deallocate(node);
+        }
+
+        // 幽灵命中后重新写入：调整p（若get时尚未调整），腾出位置后放入T2
+        template<typename... Args>
+        void reviveGhost(NodePtr node, uint64_t expireAt, Args&&... args){
+            bool hitInB2 = node->tag == ArcListTag::B2;
+            if(!node->ghostHit){
+                adaptTarget(node);
+                stats_.record(FStatsCounter::GhostHit);
+            }
+            node->setValue(std::forward<Args>(args)...);
+            size_t weight = weigh(node);
+            unlink(node);
+            if(weight > capacity_){
+                nodeMap_.erase(node->getKey());
+                pool_.deallocate(node);
+                return;
+            }
+            evictResident(weight, hitInB2);
+            node->weight = weight;
+            node->ghostHit = false;
+            pushFront(ArcListTag::T2, node);
+            setExpireAt(node, expireAt);
+            stats_.record(FStatsCounter::Put);
+        }
+
+        // 完全未命中：按论文Case IV维护|T1|+|B1|<=c以及总大小<=2c（均含将放入的weight）。
+        // B1为空时T1独占了c，直接丢弃T1末尾的条目而不留幽灵
+        void makeRoomForMiss(size_t weight){
+            while(listSize(ArcListTag::T1) + listSize(ArcListTag::B1) + weight > capacity_){
+                if(listSize(ArcListTag::B1) > 0)
+                    dropLast(ArcListTag::B1);
+                else if(listSize(ArcListTag::T1) > 0)
+                    dropLast(ArcListTag::T1);
+                else
+                    break;
+            }
+            while(listSize(ArcListTag::B2) > 0 && totalSize() + weight > 2 * capacity_)
+                dropLast(ArcListTag::B2);
+            evictResident(weight, false);
+        }
+
+        size_t totalSize(){
+            return residentSize() + listSize(ArcListTag::B1) + listSize(ArcListTag::B2);
         }
 
-        size_t transformThreshold_;
         size_t capacity_;
-        std::unique_ptr<ArcLfuPart<Key, Value>> lfuPart_;
-        std::unique_ptr<ArcLruPart<Key, Value>> lruPart_;
+        size_t transformThreshold_;
+        size_t p_;
+        FWeigher<Key, Value> weigher_;
+
+        FNodePool<NodeType> pool_;
+        NodeMap nodeMap_;
+        ArcList lists_[4];
+        std::unique_ptr<TimerWheel> timerWheel_;
+        FStatsCounter stats_;
+        FLatencyRecorder latency_;
+        std::mutex mutex_;
     };
 }
 
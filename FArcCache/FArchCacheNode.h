@@ -5,38 +5,61 @@
 #ifndef FULINCACHE_FARCHCACHENODE_H
 #define FULINCACHE_FARCHCACHENODE_H
 #include<memory>
+#include <utility>
+#include <cstdint>
+
+#include "../FValueSlot.h"
 
 namespace FulinCache {
     template<typename Key,typename Value>
-    class ArcLruPart;
+    class ArcCache;
+    template<typename Node>
+    class FTimerWheel;
 
-    template<typename Key,typename Value>
-    class ArcLfuPart;
+    // 节点当前所在的ARC链表：T1/T2为缓存中的条目，B1/B2为只保留key的幽灵条目
+    enum class ArcListTag : unsigned char {
+        T1 = 0,
+        T2 = 1,
+        B1 = 2,
+        B2 = 3
+    };
 
     template<typename Key,typename Value>
     class FArchCacheNode {
     private:
         Key key_;
-        Value value_;
+        FValueSlot<Value> value_; // 幽灵条目的value已释放
         size_t accessCount;
-        std::shared_ptr<FArchCacheNode<Key,Value>> next;
-        std::weak_ptr<FArchCacheNode<Key,Value>> prev;
+        size_t weight; // 幽灵条目保留其作为缓存条目时的权重
+        uint64_t expireAt; // 过期时间，0表示不过期；幽灵条目恒为0
+        FArchCacheNode<Key,Value>* next;
+        FArchCacheNode<Key,Value>* prev;
+        FArchCacheNode<Key,Value>* timerPrev;
+        FArchCacheNode<Key,Value>* timerNext;
+        ArcListTag tag;
+        bool ghostHit; // 幽灵条目已被get命中过，目标值p已据此调整
 
     public:
         FArchCacheNode()
-        : key_(), value_(), accessCount(1), next(nullptr) {}
-        FArchCacheNode(Key key, Value value)
-        : key_(key), value_(value), accessCount(1), next(nullptr) {}
+        : key_(), value_(), accessCount(1), weight(1), expireAt(0), next(nullptr), prev(nullptr),
+          timerPrev(nullptr), timerNext(nullptr), tag(ArcListTag::T1), ghostHit(false) {}
+        template<typename K, typename... Args>
+        explicit FArchCacheNode(K&& key, Args&&... args)
+        : key_(std::forward<K>(key)), value_(std::in_place, std::forward<Args>(args)...), accessCount(1), weight(1), expireAt(0),
+          next(nullptr), prev(nullptr), timerPrev(nullptr), timerNext(nullptr), tag(ArcListTag::T1), ghostHit(false) {}
 
-        Key getKey() const {return key_;}
-        Value getValue() const {return value_;}
-        void setValue(const Value& value) {value_ = value;}
+        const Key& getKey() const {return key_;}
+        const Value& getValue() const {return value_.get();}
+        std::shared_ptr<const Value> getHandle() const {return value_.handle();}
+        template<typename... Args>
+        void setValue(Args&&... args) {value_.set(std::forward<Args>(args)...);}
+        void clearValue() {value_.reset();}
         size_t getAccessCount() const {return accessCount;}
         void incrementAccessCount() {accessCount++;}
+        bool isGhost() const {return tag == ArcListTag::B1 || tag == ArcListTag::B2;}
 
-        friend class ArcLruPart<Key, Value>;
-
-        friend class ArcLfuPart<Key, Value>;
+        friend class ArcCache<Key, Value>;
+        friend class FTimerWheel<FArchCacheNode<Key, Value>>;
     };
 
 } // FulinCache
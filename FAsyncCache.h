@@ -0,0 +1,223 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+
+#ifndef FULINCACHE_FASYNCCACHE_H
+#define FULINCACHE_FASYNCCACHE_H
+#if !defined(__cpp_impl_coroutine)
+#error "FAsyncCache.h需要C++20协程，请以-DFULINCACHE_COROUTINES=ON配置CMake"
+#endif
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "FICachePolicy.h"
+#include "FHash.h"
+
+namespace FulinCache {
+    // 惰性启动的协程任务：被co_await时才开始执行，结束时对称转移回等待方
+    template<typename T>
+    class FTask {
+    public:
+        struct promise_type {
+            std::optional<T> value;
+            std::exception_ptr error;
+            std::coroutine_handle<> continuation;
+
+            FTask get_return_object(){
+                return FTask(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() noexcept {return {};}
+
+            struct FinalAwaiter {
+                bool await_ready() noexcept {return false;}
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept{
+                    std::coroutine_handle<> continuation = handle.promise().continuation;
+                    return continuation ? continuation : std::noop_coroutine();
+                }
+                void await_resume() noexcept {}
+            };
+
+            FinalAwaiter final_suspend() noexcept {return {};}
+
+            template<typename U>
+            void return_value(U&& result){ value.emplace(std::forward<U>(result)); }
+
+            void unhandled_exception(){ error = std::current_exception(); }
+        };
+
+        FTask(FTask&& other) noexcept: coroutine_(std::exchange(other.coroutine_, nullptr)){}
+        FTask& operator=(FTask&& other) noexcept{
+            if(this != &other){
+                if(coroutine_) coroutine_.destroy();
+                coroutine_ = std::exchange(other.coroutine_, nullptr);
+            }
+            return *this;
+        }
+        FTask(const FTask&) = delete;
+        FTask& operator=(const FTask&) = delete;
+
+        ~FTask(){
+            if(coroutine_) coroutine_.destroy();
+        }
+
+        bool await_ready() const noexcept {return false;}
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept{
+            coroutine_.promise().continuation = awaiting;
+            return coroutine_;
+        }
+
+        T await_resume(){
+            promise_type& promise = coroutine_.promise();
+            if(promise.error)
+                std::rethrow_exception(promise.error);
+            return std::move(*promise.value);
+        }
+
+    private:
+        explicit FTask(std::coroutine_handle<promise_type> coroutine): coroutine_(coroutine){}
+
+        std::coroutine_handle<promise_type> coroutine_;
+    };
+
+    // FICachePolicy之上的协程接口，语义与FLoadingCache相同：同一个key同时只有一个协程执行loader，
+    // 其余未命中的协程挂起在同一次加载上，加载完成后由加载者所在线程依次恢复，而不是阻塞工作线程。
+    // 缓存本身的锁只在查表/写入的短临界区内持有，从不跨越loader。
+    // 不持有cache，调用方需保证cache以及所有挂起中的协程的生命周期长于本对象。
+    template<typename Key, typename Value>
+    class FAsyncCache {
+    public:
+        explicit FAsyncCache(FICachePolicy<Key, Value>& cache): cache_(cache){}
+
+        FAsyncCache(const FAsyncCache&) = delete;
+        FAsyncCache& operator=(const FAsyncCache&) = delete;
+
+        // 命中返回value；该key正在加载时等待加载结果；否则返回空
+        FTask<std::optional<Value>> getAsync(Key key){
+            Value value{};
+            if(cache_.get(key, value))
+                co_return std::optional<Value>(std::move(value));
+            std::shared_ptr<Flight> flight = findFlight(key);
+            if(!flight)
+                co_return std::optional<Value>();
+            FlightAwaiter awaiter{flight};
+            Value loaded = co_await awaiter;
+            co_return std::optional<Value>(std::move(loaded));
+        }
+
+        // loader为无参可调用对象，返回可co_await出Value的对象（如FTask<Value>）。
+        // loader抛出的异常会传给所有等待该key的协程，结果不写入缓存
+        template<typename Loader>
+        FTask<Value> loadAsync(Key key, Loader loader){
+            Value value{};
+            if(cache_.get(key, value))
+                co_return value;
+
+            std::shared_ptr<Flight> flight;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = inFlight_.find(key);
+                if(it != inFlight_.end()){
+                    flight = it->second;
+                }else{
+                    // 上一个加载者可能在我们查缓存之后刚写入并移出inFlight_，加锁后再查一次
+                    if(cache_.get(key, value))
+                        co_return value;
+                    inFlight_.emplace(key, std::make_shared<Flight>());
+                }
+            }
+            if(flight){
+                FlightAwaiter awaiter{flight};
+                co_return co_await awaiter;
+            }
+
+            std::optional<Value> loaded;
+            std::exception_ptr error;
+            try{
+                loaded.emplace(co_await loader());
+                cache_.put(key, *loaded);
+            }catch(...){
+                error = std::current_exception();
+            }
+            finish(key, loaded, error);
+            if(error)
+                std::rethrow_exception(error);
+            co_return std::move(*loaded);
+        }
+
+    private:
+        // 一次进行中的加载，done之前到达的协程记录在waiters中
+        struct Flight {
+            std::mutex mutex;
+            bool done = false;
+            std::optional<Value> value;
+            std::exception_ptr error;
+            std::vector<std::coroutine_handle<>> waiters;
+        };
+
+        struct FlightAwaiter {
+            std::shared_ptr<Flight> flight;
+
+            bool await_ready(){
+                std::lock_guard<std::mutex> lock(flight->mutex);
+                return flight->done;
+            }
+
+            // 检查与登记在同一把锁内完成，加载恰好在两者之间结束时不挂起
+            bool await_suspend(std::coroutine_handle<> awaiting){
+                std::lock_guard<std::mutex> lock(flight->mutex);
+                if(flight->done)
+                    return false;
+                flight->waiters.push_back(awaiting);
+                return true;
+            }
+
+            Value await_resume(){
+                if(flight->error)
+                    std::rethrow_exception(flight->error);
+                return *flight->value;
+            }
+        };
+
+        std::shared_ptr<Flight> findFlight(const Key& key){
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = inFlight_.find(key);
+            return it != inFlight_.end() ? it->second : nullptr;
+        }
+
+        // 公布加载结果并恢复等待的协程，恢复在锁外进行
+        void finish(const Key& key, const std::optional<Value>& loaded, std::exception_ptr error){
+            std::shared_ptr<Flight> flight;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = inFlight_.find(key);
+                flight = std::move(it->second);
+                inFlight_.erase(it);
+            }
+            std::vector<std::coroutine_handle<>> waiters;
+            {
+                std::lock_guard<std::mutex> lock(flight->mutex);
+                flight->value = loaded;
+                flight->error = error;
+                flight->done = true;
+                waiters.swap(flight->waiters);
+            }
+            for(std::coroutine_handle<> waiter : waiters)
+                waiter.resume();
+        }
+
+        FICachePolicy<Key, Value>& cache_;
+        std::unordered_map<Key, std::shared_ptr<Flight>, FHash<Key>> inFlight_; // 正在加载的key
+        std::mutex mutex_;
+    };
+
+} // FulinCache
+
+#endif //FULINCACHE_FASYNCCACHE_H
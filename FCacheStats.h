@@ -0,0 +1,96 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+
+#ifndef FULINCACHE_FCACHESTATS_H
+#define FULINCACHE_FCACHESTATS_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "FThreadStripe.h"
+
+namespace FulinCache {
+    // 某一时刻的统计快照。puts只计新插入的条目，覆盖已有条目计入updates；
+    // evictions为容量淘汰，expirations为TTL过期回收，二者互不包含
+    struct FCacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t puts = 0;
+        uint64_t updates = 0;
+        uint64_t evictions = 0;
+        uint64_t expirations = 0;
+        uint64_t ghostHits = 0;   // ARC：命中B1/B2中的幽灵条目
+        uint64_t agingPasses = 0; // LFU：访问频次整体衰减的次数
+        size_t size = 0;          // 当前加权大小，未给weigher时即条目数
+
+        double hitRate() const{
+            uint64_t total = hits + misses;
+            return total ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+        }
+
+        // 分片缓存据此汇总各分片
+        FCacheStats& operator+=(const FCacheStats& other){
+            hits += other.hits;
+            misses += other.misses;
+            puts += other.puts;
+            updates += other.updates;
+            evictions += other.evictions;
+            expirations += other.expirations;
+            ghostHits += other.ghostHits;
+            agingPasses += other.agingPasses;
+            size += other.size;
+            return *this;
+        }
+    };
+
+    // 按线程分条带的计数器，每个条带独占一个缓存行，记录只是一次relaxed的fetch_add。
+    // 共享锁下的并发命中（如CLOCK、缓冲提升的LRU）不会因计数而在核间争抢同一缓存行
+    class FStatsCounter {
+    public:
+        enum Counter : size_t {
+            Hit, Miss, Put, Update, Eviction, Expiration, GhostHit, AgingPass, kCounterCount
+        };
+
+        FStatsCounter(){
+            for(Stripe& stripe : stripes_)
+                for(std::atomic<uint64_t>& counter : stripe.counters)
+                    counter.store(0, std::memory_order_relaxed);
+        }
+
+        FStatsCounter(const FStatsCounter&) = delete;
+        FStatsCounter& operator=(const FStatsCounter&) = delete;
+
+        void record(Counter counter, uint64_t n = 1){
+            stripes_[counterStripeIndex()].counters[counter].fetch_add(n, std::memory_order_relaxed);
+        }
+
+        // 各条带分别读取，与并发的记录之间不是原子快照
+        FCacheStats snapshot(size_t size) const{
+            uint64_t totals[kCounterCount] = {};
+            for(const Stripe& stripe : stripes_)
+                for(size_t i = 0; i < kCounterCount; ++i)
+                    totals[i] += stripe.counters[i].load(std::memory_order_relaxed);
+            FCacheStats stats;
+            stats.hits = totals[Hit];
+            stats.misses = totals[Miss];
+            stats.puts = totals[Put];
+            stats.updates = totals[Update];
+            stats.evictions = totals[Eviction];
+            stats.expirations = totals[Expiration];
+            stats.ghostHits = totals[GhostHit];
+            stats.agingPasses = totals[AgingPass];
+            stats.size = size;
+            return stats;
+        }
+
+    private:
+        struct alignas(64) Stripe {
+            std::atomic<uint64_t> counters[kCounterCount];
+        };
+
+        Stripe stripes_[kCounterStripes];
+    };
+
+} // FulinCache
+
+#endif //FULINCACHE_FCACHESTATS_H
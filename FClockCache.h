@@ -0,0 +1,153 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+
+#ifndef FULINCACHE_FCLOCKCACHE_H
+#define FULINCACHE_FCLOCKCACHE_H
+#include <memory>
+#include <shared_mutex>
+#include <mutex>
+#include <atomic>
+
+#include "FICachePolicy.h"
+#include "FFlatMap.h"
+
+namespace FulinCache {
+    // CLOCK：条目存放在定长槽数组中，命中时只在共享锁下原子地置位引用位，不修改任何链表；
+    // 需要淘汰时由时钟指针扫描槽数组，清除引用位并淘汰第一个未被引用的条目。
+    template<typename Key, typename Value>
+    class FClockCache: public FICachePolicy<Key, Value> {
+    public:
+        explicit FClockCache(size_t capacity)
+        : capacity_(capacity)
+        , slots_(capacity > 0 ? new Slot[capacity] : nullptr)
+        , size_(0)
+        , hand_(0){}
+
+        ~FClockCache() override = default;
+
+        bool get(const Key& key, Value& value) override{
+            return getImpl(key, value);
+        }
+
+        Value get(const Key& key) override{
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        template<typename K, typename = FEnableTransparent<Key, K>>
+        bool get(const K& key, Value& value){
+            return getImpl(key, value);
+        }
+
+        template<typename K, typename = FEnableTransparent<Key, K>>
+        Value get(const K& key){
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        void put(const Key& key, const Value& value) override{
+            putSlot(key, value);
+        }
+
+        void put(Key key, Value&& value) override{
+            putSlot(std::move(key), std::move(value));
+        }
+
+        // 槽位预先分配，value由args构造后移动赋值进槽位
+        template<typename... Args>
+        void emplace(const Key& key, Args&&... args){
+            putSlot(key, std::forward<Args>(args)...);
+        }
+
+        FCacheStats stats() override{
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            return stats_.snapshot(size_);
+        }
+
+        FLatencyHistogram latency(FCacheOp op) override{
+            FLatencyHistogram histogram;
+            latency_.mergeInto(op, histogram);
+            return histogram;
+        }
+
+    private:
+        template<typename K>
+        bool getImpl(const K& key, Value& value){
+            FLatencyTimer timer(latency_, FCacheOp::Get);
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            Slot* slot = slotMap_.find(key);
+            if(!slot){
+                stats_.record(FStatsCounter::Miss);
+                return false;
+            }
+            stats_.record(FStatsCounter::Hit);
+            value = slot->value;
+            // 已置位时不再写，避免热点key所在缓存行在核间来回失效
+            if(!slot->referenced.load(std::memory_order_relaxed))
+                slot->referenced.store(true, std::memory_order_relaxed);
+            return true;
+        }
+
+        struct Slot{
+            Slot(): key(), value(), referenced(false){}
+
+            const Key& getKey() const {return key;}
+
+            Key key;
+            Value value;
+            std::atomic<bool> referenced;
+        };
+
+        template<typename K, typename... Args>
+        void putSlot(K&& key, Args&&... args){
+            if(capacity_ == 0) return;
+            FLatencyTimer timer(latency_, FCacheOp::Put);
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            Slot* slot = slotMap_.find(key);
+            if(slot){
+                slot->value = Value(std::forward<Args>(args)...);
+                slot->referenced.store(true, std::memory_order_relaxed);
+                stats_.record(FStatsCounter::Update);
+                return;
+            }
+            slot = &slots_[size_ < capacity_ ? size_++ : evict()];
+            slot->key = std::forward<K>(key);
+            slot->value = Value(std::forward<Args>(args)...);
+            slot->referenced.store(false, std::memory_order_relaxed);
+            slotMap_.insert(slot);
+            stats_.record(FStatsCounter::Put);
+        }
+
+        // 返回被腾出的槽位下标
+        size_t evict(){
+            FLatencyTimer timer(latency_, FCacheOp::Evict);
+            while(true){
+                Slot& slot = slots_[hand_];
+                size_t index = hand_;
+                hand_ = (hand_ + 1) % capacity_;
+                if(slot.referenced.load(std::memory_order_relaxed)){
+                    slot.referenced.store(false, std::memory_order_relaxed);
+                    continue;
+                }
+                slotMap_.erase(slot.key);
+                stats_.record(FStatsCounter::Eviction);
+                return index;
+            }
+        }
+
+        size_t capacity_;
+        std::unique_ptr<Slot[]> slots_;
+        FFlatMap<Key, Slot> slotMap_;
+        size_t size_;
+        size_t hand_;
+        FStatsCounter stats_;
+        FLatencyRecorder latency_;
+        std::shared_mutex mutex_;
+    };
+
+} // FulinCache
+
+#endif //FULINCACHE_FCLOCKCACHE_H
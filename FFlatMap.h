@@ -0,0 +1,284 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+
+#ifndef FULINCACHE_FFLATMAP_H
+#define FULINCACHE_FFLATMAP_H
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+#include "FHash.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FULINCACHE_FLATMAP_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <xmmintrin.h>
+#endif
+
+namespace FulinCache {
+    // 缓存内部使用的开放寻址哈希表，只保存节点指针，key从节点的getKey()取得。
+    // 每个槽位对应1字节控制标签（空/已删除/哈希值低7位），按16个一组探测，
+    // 有SSE2时一次比较整组标签，否则逐字节比较。不负责节点的生命周期。
+    // 查找接口接受任意K，Hash与KeyEqual透明时（见FHash）可不构造Key直接查找。
+    template<typename Key, typename Node, typename Hash = FHash<Key>, typename KeyEqual = FEqualTo>
+    class FFlatMap {
+    public:
+        explicit FFlatMap(size_t expectedSize = 0)
+        : ctrl_(nullptr)
+        , capacity_(0)
+        , size_(0)
+        , deleted_(0){
+            if(expectedSize > 0)
+                reserve(expectedSize);
+        }
+
+        FFlatMap(const FFlatMap&) = delete;
+        FFlatMap& operator=(const FFlatMap&) = delete;
+
+        size_t size() const {return size_;}
+        bool empty() const {return size_ == 0;}
+
+        template<typename K>
+        size_t hash(const K& key) const{
+            return mix(hasher_(key));
+        }
+
+        template<typename K>
+        Node* find(const K& key) const{
+            return find(key, hash(key));
+        }
+
+        template<typename K>
+        Node* find(const K& key, size_t hash) const{
+            size_t index = findIndex(key, hash);
+            return index != kNotFound ? slots_[index] : nullptr;
+        }
+
+        // 预取hash对应的首个探测组的控制字节和槽位，批量查找时先对一批key预取再逐个find，
+        // 让各key的内存访问延迟相互重叠
+        void prefetch(size_t hash) const{
+            if(capacity_ == 0) return;
+            size_t index = (h1(hash) & groupMask()) * kGroupWidth;
+            prefetchLine(ctrl_ + index);
+            prefetchLine(slots_.get() + index);
+            prefetchLine(slots_.get() + index + kGroupWidth / 2);
+        }
+
+        // 在prefetch之后调用：只比较首个探测组的标签，预取标签匹配的槽位所指的节点，不解引用节点。
+        // 随后的find比较key时节点多半已在缓存中
+        void prefetchNode(size_t hash) const{
+            if(capacity_ == 0) return;
+            size_t groupIndex = h1(hash) & groupMask();
+            uint32_t candidates = match(group(groupIndex), h2(hash));
+            while(candidates){
+                prefetchLine(slots_[groupIndex * kGroupWidth + countTrailingZeros(candidates)]);
+                candidates &= candidates - 1;
+            }
+        }
+
+        // 调用方需保证key不在表中
+        void insert(Node* node){
+            insert(node, hash(node->getKey()));
+        }
+
+        void insert(Node* node, size_t hash){
+            if(size_ + deleted_ + 1 > maxLoad(capacity_))
+                rehash(size_ + 1 > maxLoad(capacity_) ? capacity_ * 2 : capacity_);
+            size_t index = findInsertIndex(hash);
+            if(ctrl_[index] == kDeleted) deleted_--;
+            setCtrl(index, h2(hash));
+            slots_[index] = node;
+            size_++;
+        }
+
+        bool erase(const Key& key){
+            size_t index = findIndex(key, hash(key));
+            if(index == kNotFound) return false;
+            eraseAt(index);
+            return true;
+        }
+
+        void reserve(size_t expectedSize){
+            size_t capacity = kGroupWidth;
+            while(maxLoad(capacity) < expectedSize) capacity *= 2;
+            if(capacity > capacity_) rehash(capacity);
+        }
+
+        void clear(){
+            if(capacity_ > 0)
+                std::memset(ctrl_, static_cast<unsigned char>(kEmpty), capacity_);
+            size_ = 0;
+            deleted_ = 0;
+        }
+
+        template<typename Func>
+        void forEach(Func&& func) const{
+            for(size_t i = 0; i < capacity_; ++i)
+                if(isFull(ctrl_[i])) func(slots_[i]);
+        }
+
+        // 预取address所在的缓存行，只是提示，不会解引用
+        static void prefetchLine(const void* address){
+#if defined(_MSC_VER)
+            _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+            __builtin_prefetch(address);
+#endif
+        }
+
+    private:
+        using ctrl_t = int8_t;
+        static constexpr ctrl_t kEmpty = -128;
+        static constexpr ctrl_t kDeleted = -2;
+        static constexpr size_t kGroupWidth = 16;
+        static constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+        struct alignas(kGroupWidth) Group{
+            ctrl_t ctrl[kGroupWidth];
+        };
+
+        static bool isFull(ctrl_t ctrl) {return ctrl >= 0;}
+
+        // std::hash对整数是恒等映射，先打散再分出组下标（高位）和标签（低7位）
+        static size_t mix(size_t hash){
+            uint64_t x = static_cast<uint64_t>(hash) * 0x9e3779b97f4a7c15ULL;
+            return static_cast<size_t>(x ^ (x >> 32));
+        }
+        static size_t h1(size_t hash) {return hash >> 7;}
+        static ctrl_t h2(size_t hash) {return static_cast<ctrl_t>(hash & 0x7F);}
+
+        static size_t maxLoad(size_t capacity) {return capacity - capacity / 8;}
+
+        static uint32_t countTrailingZeros(uint32_t mask){
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return static_cast<uint32_t>(index);
+#else
+            return static_cast<uint32_t>(__builtin_ctz(mask));
+#endif
+        }
+
+        const ctrl_t* group(size_t groupIndex) const{
+            return ctrl_ + groupIndex * kGroupWidth;
+        }
+
+        static uint32_t match(const ctrl_t* group, ctrl_t tag){
+#ifdef FULINCACHE_FLATMAP_SSE2
+            __m128i ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(tag))));
+#else
+            uint32_t mask = 0;
+            for(size_t i = 0; i < kGroupWidth; ++i)
+                if(group[i] == tag) mask |= 1u << i;
+            return mask;
+#endif
+        }
+
+        // 空槽与已删除槽的最高位都是1，满槽为0
+        static uint32_t matchEmptyOrDeleted(const ctrl_t* group){
+#ifdef FULINCACHE_FLATMAP_SSE2
+            __m128i ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+            return static_cast<uint32_t>(_mm_movemask_epi8(ctrl));
+#else
+            uint32_t mask = 0;
+            for(size_t i = 0; i < kGroupWidth; ++i)
+                if(group[i] < 0) mask |= 1u << i;
+            return mask;
+#endif
+        }
+
+        size_t groupMask() const {return capacity_ / kGroupWidth - 1;}
+
+        template<typename K>
+        size_t findIndex(const K& key, size_t hash) const{
+            if(capacity_ == 0) return kNotFound;
+            size_t mask = groupMask();
+            size_t groupIndex = h1(hash) & mask;
+            ctrl_t tag = h2(hash);
+            for(size_t step = 1; step <= mask + 1; ++step){
+                const ctrl_t* ctrl = group(groupIndex);
+                uint32_t candidates = match(ctrl, tag);
+                while(candidates){
+                    size_t index = groupIndex * kGroupWidth + countTrailingZeros(candidates);
+                    if(keyEqual_(slots_[index]->getKey(), key))
+                        return index;
+                    candidates &= candidates - 1;
+                }
+                if(match(ctrl, kEmpty))
+                    return kNotFound;
+                groupIndex = (groupIndex + step) & mask; // 三角数步长，组数为2的幂时可遍历所有组
+            }
+            return kNotFound;
+        }
+
+        size_t findInsertIndex(size_t hash) const{
+            size_t mask = groupMask();
+            size_t groupIndex = h1(hash) & mask;
+            for(size_t step = 1; ; ++step){
+                uint32_t candidates = matchEmptyOrDeleted(group(groupIndex));
+                if(candidates)
+                    return groupIndex * kGroupWidth + countTrailingZeros(candidates);
+                groupIndex = (groupIndex + step) & mask;
+            }
+        }
+
+        void setCtrl(size_t index, ctrl_t ctrl){
+            ctrl_[index] = ctrl;
+        }
+
+        // 所在组里还有空槽时，探测序列不可能越过这一组，可以直接置空而不留墓碑
+        void eraseAt(size_t index){
+            size_t groupIndex = index / kGroupWidth;
+            if(match(group(groupIndex), kEmpty)){
+                setCtrl(index, kEmpty);
+            }else{
+                setCtrl(index, kDeleted);
+                deleted_++;
+            }
+            size_--;
+        }
+
+        void rehash(size_t newCapacity){
+            if(newCapacity < kGroupWidth) newCapacity = kGroupWidth;
+            std::unique_ptr<Group[]> oldGroups = std::move(groups_);
+            std::unique_ptr<Node*[]> oldSlots = std::move(slots_);
+            const ctrl_t* oldCtrl = ctrl_;
+            size_t oldCapacity = capacity_;
+
+            groups_.reset(new Group[newCapacity / kGroupWidth]);
+            ctrl_ = groups_[0].ctrl;
+            std::memset(ctrl_, static_cast<unsigned char>(kEmpty), newCapacity);
+            slots_.reset(new Node*[newCapacity]);
+            capacity_ = newCapacity;
+            size_ = 0;
+            deleted_ = 0;
+
+            for(size_t i = 0; i < oldCapacity; ++i){
+                if(!isFull(oldCtrl[i])) continue;
+                size_t hash = this->hash(oldSlots[i]->getKey());
+                size_t index = findInsertIndex(hash);
+                setCtrl(index, h2(hash));
+                slots_[index] = oldSlots[i];
+                size_++;
+            }
+        }
+
+        std::unique_ptr<Group[]> groups_;
+        ctrl_t* ctrl_; // groups_的逐字节视图
+        std::unique_ptr<Node*[]> slots_;
+        size_t capacity_;
+        size_t size_;
+        size_t deleted_;
+        Hash hasher_;
+        KeyEqual keyEqual_;
+    };
+
+} // FulinCache
+
+#endif //FULINCACHE_FFLATMAP_H
@@ -0,0 +1,51 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+
+#ifndef FULINCACHE_FHASH_H
+#define FULINCACHE_FHASH_H
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace FulinCache {
+    // 各缓存与FFlatMap统一使用的哈希。默认等价于std::hash<Key>；
+    // std::string特化为透明哈希，可直接用string_view/const char*查找而不构造临时string。
+    // 自定义key类型可照此特化并声明is_transparent。
+    template<typename Key>
+    struct FHash: std::hash<Key> {};
+
+    template<>
+    struct FHash<std::string> {
+        using is_transparent = void;
+
+        // 标准保证与std::hash<std::string>对同一字符序列的结果一致
+        size_t operator()(std::string_view key) const{
+            return std::hash<std::string_view>{}(key);
+        }
+    };
+
+    struct FEqualTo {
+        using is_transparent = void;
+
+        template<typename A, typename B>
+        bool operator()(const A& a, const B& b) const{
+            return a == b;
+        }
+    };
+
+    template<typename Hash, typename = void>
+    struct FIsTransparent: std::false_type {};
+
+    template<typename Hash>
+    struct FIsTransparent<Hash, std::void_t<typename Hash::is_transparent>>: std::true_type {};
+
+    // 缓存的get/contains对非Key类型K的重载只在FHash<Key>透明时参与重载决议
+    template<typename Key, typename K>
+    using FEnableTransparent = std::enable_if_t<
+            FIsTransparent<FHash<Key>>::value && !std::is_same<std::decay_t<K>, Key>::value>;
+
+} // FulinCache
+
+#endif //FULINCACHE_FHASH_H
@@ -4,19 +4,84 @@
 
 #ifndef FULINCACHE_FICACHEPOLICY_H
 #define FULINCACHE_FICACHEPOLICY_H
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <functional>
+
+#include "FSpan.h"
+#include "FValueSlot.h"
+#include "FCacheStats.h"
+#include "FLatencyHistogram.h"
 
 namespace FulinCache {
+    // 指向缓存中value的只读引用计数句柄。条目被淘汰或覆盖后，持有句柄的一方读到的仍是原value，
+    // value的内存在最后一个句柄释放时才回收
+    template<typename Value>
+    using FValueHandle = std::shared_ptr<const Value>;
+
+    // 计算条目的权重（如value占用的字节数），缓存据此把capacity当作总权重预算；
+    // 为空时每个条目权重为1，capacity即条目数
+    template<typename Key, typename Value>
+    using FWeigher = std::function<size_t(const Key&, const Value&)>;
+
     template<typename Key, typename Value>
     class FICachePolicy {
     public:
         FICachePolicy() = default;
         virtual ~FICachePolicy() = default;
 
-        virtual void put(Key key, Value value) = 0;
+        virtual void put(const Key& key, const Value& value) = 0;
+
+        // value为右值时移动进缓存而不拷贝；key按值传入，临时key同样会被移动
+        virtual void put(Key key, Value&& value) = 0;
+
+        virtual bool get(const Key& key, Value& value) = 0;
+
+        virtual Value get(const Key& key) = 0;
+
+        // 以句柄读取value，未命中返回空句柄。value类型特化了FSharedValue时，内置缓存直接交出节点里的句柄，
+        // 不拷贝value；否则与默认实现一样拷贝一次
+        virtual FValueHandle<Value> getHandle(const Key& key){
+            Value value{};
+            if(!get(key, value))
+                return nullptr;
+            return std::make_shared<const Value>(std::move(value));
+        }
+
+        // 批量读取：values[i]、hits[i]对应keys[i]，返回命中个数。values或hits比keys短时只处理前面对得上的部分。
+        // 默认实现逐个调用get，具体缓存可覆盖为整批只加一次锁，此时整批计一次Get延迟。
+        virtual size_t getMany(FSpan<const Key> keys, FSpan<Value> values, FSpan<bool> hits){
+            keys = batchKeys(keys, values, hits);
+            size_t hitCount = 0;
+            for(size_t i = 0; i < keys.size(); ++i){
+                hits[i] = get(keys[i], values[i]);
+                if(hits[i]) hitCount++;
+            }
+            return hitCount;
+        }
+
+        virtual void putMany(FSpan<const Key> keys, FSpan<const Value> values){
+            keys = keys.first(values.size());
+            for(size_t i = 0; i < keys.size(); ++i)
+                put(keys[i], values[i]);
+        }
+
+        // 截去keys中超出values、hits长度的部分，防止批量接口越界写
+        static FSpan<const Key> batchKeys(FSpan<const Key> keys, FSpan<Value> values, FSpan<bool> hits){
+            return keys.first(std::min(values.size(), hits.size()));
+        }
 
-        virtual bool get(Key key, Value& value) = 0;
+        // 命中、未命中、淘汰等计数的快照。不做统计的实现返回全0
+        virtual FCacheStats stats(){
+            return FCacheStats{};
+        }
 
-        virtual Value get(Key key) = 0;
+        // op类操作的延迟分布，需以FULINCACHE_LATENCY编译，否则为空直方图
+        virtual FLatencyHistogram latency(FCacheOp op){
+            (void)op;
+            return FLatencyHistogram();
+        }
     };
 
 } // FulinCache
@@ -0,0 +1,226 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+
+#ifndef FULINCACHE_FLATENCYHISTOGRAM_H
+#define FULINCACHE_FLATENCYHISTOGRAM_H
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "FCacheStats.h"
+
+namespace FulinCache {
+    // 缓存内部计时的操作类型。Get/Put为单次get/put（含等锁时间），
+    // Evict为一次容量淘汰，Maintain为LFU频次衰减、时间轮推进、读缓冲回放等维护工作
+    enum class FCacheOp : size_t {
+        Get, Put, Evict, Maintain
+    };
+
+    constexpr size_t kCacheOpCount = 4;
+
+    struct FLatencySummary {
+        uint64_t count = 0;
+        uint64_t p50 = 0;  // 以下均为纳秒
+        uint64_t p99 = 0;
+        uint64_t p999 = 0;
+        uint64_t max = 0;
+    };
+
+    // 对数-线性（HDR式）延迟直方图：每个2的幂区间再等分为32个子桶，相对误差不超过1/32，
+    // 小于32ns的值精确记录，超过约18分钟的值计入最后一个桶。
+    // 桶计数为relaxed原子量，多线程可直接并发记录；merge把另一个直方图累加进来，用于汇总各线程或各分片
+    class FLatencyHistogram {
+    public:
+        FLatencyHistogram()
+        : buckets_(new std::atomic<uint64_t>[kBucketCount]())
+        , count_(0)
+        , max_(0){}
+
+        FLatencyHistogram(const FLatencyHistogram& other): FLatencyHistogram(){
+            merge(other);
+        }
+
+        FLatencyHistogram& operator=(const FLatencyHistogram&) = delete;
+
+        void record(uint64_t nanos){
+            buckets_[bucketIndex(nanos)].fetch_add(1, std::memory_order_relaxed);
+            count_.fetch_add(1, std::memory_order_relaxed);
+            uint64_t max = max_.load(std::memory_order_relaxed);
+            while(nanos > max && !max_.compare_exchange_weak(max, nanos, std::memory_order_relaxed)){}
+        }
+
+        void merge(const FLatencyHistogram& other){
+            for(size_t i = 0; i < kBucketCount; ++i){
+                uint64_t n = other.buckets_[i].load(std::memory_order_relaxed);
+                if(n) buckets_[i].fetch_add(n, std::memory_order_relaxed);
+            }
+            count_.fetch_add(other.count_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            uint64_t otherMax = other.max_.load(std::memory_order_relaxed);
+            uint64_t max = max_.load(std::memory_order_relaxed);
+            while(otherMax > max && !max_.compare_exchange_weak(max, otherMax, std::memory_order_relaxed)){}
+        }
+
+        uint64_t count() const {return count_.load(std::memory_order_relaxed);}
+        uint64_t max() const {return max_.load(std::memory_order_relaxed);}
+
+        // q取[0,1]，返回第q分位所在桶的上界（不超过记录到的最大值），没有记录时返回0
+        uint64_t percentile(double q) const{
+            uint64_t total = count();
+            if(total == 0) return 0;
+            uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total) + 0.5);
+            if(rank < 1) rank = 1;
+            if(rank > total) rank = total;
+            uint64_t seen = 0;
+            for(size_t i = 0; i < kBucketCount; ++i){
+                seen += buckets_[i].load(std::memory_order_relaxed);
+                if(seen >= rank)
+                    return std::min(bucketUpper(i), max());
+            }
+            return max();
+        }
+
+        FLatencySummary summary() const{
+            FLatencySummary summary;
+            summary.count = count();
+            summary.p50 = percentile(0.5);
+            summary.p99 = percentile(0.99);
+            summary.p999 = percentile(0.999);
+            summary.max = max();
+            return summary;
+        }
+
+    private:
+        static constexpr unsigned kSubBits = 5;
+        static constexpr uint64_t kSubCount = uint64_t(1) << kSubBits;
+        static constexpr unsigned kMaxExponent = 40;
+        static constexpr size_t kBucketCount = (kMaxExponent - kSubBits + 1) * kSubCount;
+
+        // 小于kSubCount的值占第0组；[2^e, 2^(e+1))占第e-kSubBits+1组，组内按高kSubBits+1位线性细分
+        static size_t bucketIndex(uint64_t value){
+            if(value < kSubCount)
+                return static_cast<size_t>(value);
+            unsigned exponent = 63 - countLeadingZeros(value);
+            if(exponent >= kMaxExponent)
+                return kBucketCount - 1;
+            unsigned shift = exponent - kSubBits;
+            return static_cast<size_t>((shift + 1) * kSubCount + ((value >> shift) - kSubCount));
+        }
+
+        static uint64_t bucketUpper(size_t index){
+            if(index < kSubCount)
+                return index;
+            uint64_t shift = index / kSubCount - 1;
+            uint64_t sub = index % kSubCount;
+            return ((kSubCount + sub + 1) << shift) - 1;
+        }
+
+        static unsigned countLeadingZeros(uint64_t value){
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_clzll(value));
+#else
+            unsigned n = 0;
+            for(uint64_t bit = uint64_t(1) << 63; !(value & bit); bit >>= 1) ++n;
+            return n;
+#endif
+        }
+
+        std::unique_ptr<std::atomic<uint64_t>[]> buckets_;
+        std::atomic<uint64_t> count_;
+        std::atomic<uint64_t> max_;
+    };
+
+    // 缓存内按操作类型分别记录的直方图。只有定义了FULINCACHE_LATENCY时才分配直方图并计时，
+    // 否则本类与FLatencyTimer都是空的，记录点编译后不产生任何代码。
+    // 与FStatsCounter一样按线程分条带，各线程记录到自己条带的直方图，共享锁下的并发命中不会争抢同一批计数；
+    // 条带在该号线程第一次记录时才分配，mergeInto汇总所有已分配的条带
+    class FLatencyRecorder {
+    public:
+#ifdef FULINCACHE_LATENCY
+        static constexpr bool kEnabled = true;
+
+        FLatencyRecorder(){
+            for(std::atomic<Stripe*>& stripe : stripes_)
+                stripe.store(nullptr, std::memory_order_relaxed);
+        }
+
+        ~FLatencyRecorder(){
+            for(std::atomic<Stripe*>& stripe : stripes_)
+                delete stripe.load(std::memory_order_relaxed);
+        }
+
+        FLatencyRecorder(const FLatencyRecorder&) = delete;
+        FLatencyRecorder& operator=(const FLatencyRecorder&) = delete;
+
+        void record(FCacheOp op, uint64_t nanos){
+            localStripe().histograms[static_cast<size_t>(op)].record(nanos);
+        }
+
+        void mergeInto(FCacheOp op, FLatencyHistogram& target) const{
+            for(const std::atomic<Stripe*>& slot : stripes_){
+                const Stripe* stripe = slot.load(std::memory_order_acquire);
+                if(stripe)
+                    target.merge(stripe->histograms[static_cast<size_t>(op)]);
+            }
+        }
+
+    private:
+        struct alignas(64) Stripe {
+            FLatencyHistogram histograms[kCacheOpCount];
+        };
+
+        Stripe& localStripe(){
+            std::atomic<Stripe*>& slot = stripes_[counterStripeIndex()];
+            Stripe* stripe = slot.load(std::memory_order_acquire);
+            if(!stripe){
+                // 同号的多个线程可能同时分配，只保留先装上的那个
+                std::unique_ptr<Stripe> fresh(new Stripe());
+                if(slot.compare_exchange_strong(stripe, fresh.get(), std::memory_order_acq_rel))
+                    stripe = fresh.release();
+            }
+            return *stripe;
+        }
+
+        std::atomic<Stripe*> stripes_[kCounterStripes];
+#else
+        static constexpr bool kEnabled = false;
+
+        void record(FCacheOp, uint64_t){}
+        void mergeInto(FCacheOp, FLatencyHistogram&) const{}
+#endif
+    };
+
+    // 作用域计时：构造时取时间，析构时把耗时记录到对应操作的直方图
+    class FLatencyTimer {
+    public:
+#ifdef FULINCACHE_LATENCY
+        FLatencyTimer(FLatencyRecorder& recorder, FCacheOp op)
+        : recorder_(recorder)
+        , op_(op)
+        , start_(std::chrono::steady_clock::now()){}
+
+        ~FLatencyTimer(){
+            auto elapsed = std::chrono::steady_clock::now() - start_;
+            recorder_.record(op_, static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+
+    private:
+        FLatencyRecorder& recorder_;
+        FCacheOp op_;
+        std::chrono::steady_clock::time_point start_;
+#else
+        FLatencyTimer(FLatencyRecorder&, FCacheOp){}
+#endif
+
+    public:
+        FLatencyTimer(const FLatencyTimer&) = delete;
+        FLatencyTimer& operator=(const FLatencyTimer&) = delete;
+    };
+
+} // FulinCache
+
+#endif //FULINCACHE_FLATENCYHISTOGRAM_H
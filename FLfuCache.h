@@ -5,214 +5,701 @@
 #ifndef FULINCACHE_FLFUCACHE_H
 #define FULINCACHE_FLFUCACHE_H
 #include <memory>
-#include <unordered_map>
 #include <mutex>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstddef>
 
 #include "FICachePolicy.h"
+#include "FNodePool.h"
+#include "FFlatMap.h"
+#include "FSliceBatch.h"
+#include "FTimerWheel.h"
 
 namespace FulinCache{
     template<typename Key, typename Value> class FLfuCache;
+    template<typename Key, typename Value> class FHashLfuCache;
 
+    // 同一访问频次的节点链表，各频次链表按频次升序串成一条双向链，节点记录自己所在的链表
     template<typename Key, typename Value>
     class FreqList{
     public:
         struct Node{
-            Node(): accessCount(1), next(nullptr) {}
-            Node(Key key, Value value):
-                    key_(key), value_(value),accessCount(1),next(nullptr),prev(){}
+            Node(): weight(1), expireAt(0), list(nullptr), next(nullptr), prev(nullptr),
+                    timerPrev(nullptr), timerNext(nullptr) {}
+            template<typename K, typename... Args>
+            explicit Node(K&& key, Args&&... args):
+                    key_(std::forward<K>(key)), value_(std::in_place, std::forward<Args>(args)...),
+                    weight(1),expireAt(0),list(nullptr),next(nullptr),prev(nullptr),
+                    timerPrev(nullptr),timerNext(nullptr){}
 
-            Value getValue() const {return value_;}
-            Key getKey() const {return key_;}
-            void setValue(const Value& value) {value_ = value;}
-            size_t getAccessCount() const {return accessCount;}
-            void incrementAccessCount() {accessCount++;}
+            const Value& getValue() const {return value_.get();}
+            FValueHandle<Value> getHandle() const {return value_.handle();}
+            const Key& getKey() const {return key_;}
+            template<typename... Args>
+            void setValue(Args&&... args) {value_.set(std::forward<Args>(args)...);}
+            size_t getAccessCount() const {return list ? list->freq_ : 0;}
 
-            size_t accessCount;
             Key key_;
-            Value value_;
-            std::shared_ptr<Node> next;
-            std::weak_ptr<Node> prev;
+            FValueSlot<Value> value_;
+            size_t weight;
+            uint64_t expireAt; // 过期时间，0表示不过期
+            FreqList* list;
+            Node* next;
+            Node* prev;
+            Node* timerPrev;
+            Node* timerNext;
         };
-        using NodePtr = std::shared_ptr<Node>;
-        explicit FreqList(int n)
-        : freq_(n){
-            head_ = std::make_shared<Node>();
-            tail_ = std::make_shared<Node>();
-            head_->next = tail_;
-            tail_->prev = head_;
+        using NodePtr = Node*;
+        explicit FreqList(size_t n)
+        : freq_(n)
+        , size_(0)
+        , prevList_(nullptr)
+        , nextList_(nullptr){
+            head_.next = &tail_;
+            tail_.prev = &head_;
         }
 
+        FreqList(const FreqList&) = delete;
+        FreqList& operator=(const FreqList&) = delete;
+
         bool empty() const{
-            return head_->next == tail_;
+            return head_.next == &tail_;
         }
 
         void addToFront(NodePtr node){
-            node->next = head_->next;
-            node->prev = head_;
-            head_->next ->prev =  node;
-            head_->next = node;
+            node->next = head_.next;
+            node->prev = &head_;
+            head_.next->prev = node;
+            head_.next = node;
+            node->list = this;
+            size_++;
         }
 
         NodePtr removeLast(){
-            NodePtr last = tail_->prev.lock();
-            if(last && last != head_){
+            NodePtr last = tail_.prev;
+            if(last && last != &head_){
                 removeNode(last);
                 return last;
             }
             return nullptr;
         }
         void removeNode(NodePtr node){
-            if(!node->prev.expired() && node->next){
-                auto prev = node->prev.lock();
-                prev->next = node->next;
+            if(node->prev && node->next){
+                node->prev->next = node->next;
                 node->next->prev = node->prev;
                 node->next = nullptr;
+                node->prev = nullptr;
+                node->list = nullptr;
+                size_--;
             }
         }
 
+        // 把other的全部节点整体接到本链表头部，other变为空
+        void spliceFront(FreqList& other){
+            if(other.empty()) return;
+            for(NodePtr node = other.head_.next; node != &other.tail_; node = node->next)
+                node->list = this;
+            NodePtr first = other.head_.next;
+            NodePtr last = other.tail_.prev;
+            last->next = head_.next;
+            head_.next->prev = last;
+            head_.next = first;
+            first->prev = &head_;
+            other.head_.next = &other.tail_;
+            other.tail_.prev = &other.head_;
+            size_ += other.size_;
+            other.size_ = 0;
+        }
 
     private:
-        NodePtr head_;
-        NodePtr tail_;
+        Node head_;
+        Node tail_;
         size_t freq_;
+        size_t size_;
+        FreqList* prevList_;
+        FreqList* nextList_;
         friend class FLfuCache<Key,Value>;
 };
 
     template<typename Key, typename Value>
     class FLfuCache: public FICachePolicy<Key, Value> {
     public:
-        using NodeType = typename FreqList<Key,Value>::Node;
-        using NodePtr = std::shared_ptr<NodeType>;
-        using NodeMap = std::unordered_map<Key, NodePtr>;
+        using FreqListType = FreqList<Key,Value>;
+        using NodeType = typename FreqListType::Node;
+        using NodePtr = NodeType*;
+        using NodeMap = FFlatMap<Key, NodeType>;
+        using TimerWheel = FTimerWheel<NodeType>;
 
-        explicit FLfuCache(size_t capacity_, int maxAverageAccess = 10)
+        // 给出weigher时capacity是总权重预算，插入时淘汰最不常用的条目直到放得下新条目
+        explicit FLfuCache(size_t capacity_, int maxAverageAccess = 10, FWeigher<Key, Value> weigher = nullptr)
         : capacity_(capacity_)
-        , minFreq_(0)
-        , maxAverageAccess_(maxAverageAccess)
+        , weightedSize_(0)
+        , weigher_(std::move(weigher))
+        , minFreqList_(nullptr)
         , totalAccessCount_(0)
-        , currentAverageAccess_(0)
+        , maxAverageAccess_(maxAverageAccess)
+        , sharedSize_(nullptr)
         {}
 
-        ~FLfuCache() override = default;
+        ~FLfuCache() override{
+            nodeMap_.forEach([this](NodePtr node){
+                pool_.deallocate(node);
+            });
+            while(minFreqList_)
+                removeFreqList(minFreqList_);
+        }
 
-        void put(Key key, Value value) override{
+        void put(const Key& key, const Value& value) override{
+            FLatencyTimer timer(latency_, FCacheOp::Put);
             std::lock_guard<std::mutex> lock(mutex_);
-            auto it = nodeMap_.find(key);
-            if(it != nodeMap_.end()){
-                it->second->setValue(value);
-                updateAccessCount(it->second);
-                return;
-            }
-            if(nodeMap_.size() >= capacity_)
-                evictLeastFrequent();
-            addNewNode(key, value);
+            expireEntries();
+            putInternal(0, key, value);
         }
 
-        bool get(Key key, Value& value) override{
+        void put(Key key, Value&& value) override{
+            FLatencyTimer timer(latency_, FCacheOp::Put);
             std::lock_guard<std::mutex> lock(mutex_);
-            auto it = nodeMap_.find(key);
-            if(it != nodeMap_.end()){
-                value = it->second->getValue();
-                updateAccessCount(it->second);
-                return true;
-            }
-            return false;
+            expireEntries();
+            putInternal(0, std::move(key), std::move(value));
         }
 
-        Value get(Key key) override{
+        // 条目在ttl后过期，get时惰性删除，写操作与tick()时由时间轮回收；不带ttl的put会清除过期时间
+        void put(const Key& key, const Value& value, std::chrono::nanoseconds ttl){
+            FLatencyTimer timer(latency_, FCacheOp::Put);
+            std::lock_guard<std::mutex> lock(mutex_);
+            expireEntries();
+            putInternal(TimerWheel::deadline(ttl), key, value);
+        }
+
+        void put(Key key, Value&& value, std::chrono::nanoseconds ttl){
+            FLatencyTimer timer(latency_, FCacheOp::Put);
+            std::lock_guard<std::mutex> lock(mutex_);
+            expireEntries();
+            putInternal(TimerWheel::deadline(ttl), std::move(key), std::move(value));
+        }
+
+        // 用args在节点内直接构造value
+        template<typename... Args>
+        void emplace(const Key& key, Args&&... args){
+            FLatencyTimer timer(latency_, FCacheOp::Put);
+            std::lock_guard<std::mutex> lock(mutex_);
+            expireEntries();
+            putInternal(0, key, std::forward<Args>(args)...);
+        }
+
+        bool get(const Key& key, Value& value) override{
+            FLatencyTimer timer(latency_, FCacheOp::Get);
+            std::lock_guard<std::mutex> lock(mutex_);
+            return getInternal(key, value);
+        }
+
+        Value get(const Key& key) override{
             Value value{};
             get(key, value);
             return value;
         }
 
+        template<typename K, typename = FEnableTransparent<Key, K>>
+        bool get(const K& key, Value& value){
+            FLatencyTimer timer(latency_, FCacheOp::Get);
+            std::lock_guard<std::mutex> lock(mutex_);
+            return getInternal(key, value);
+        }
+
+        template<typename K, typename = FEnableTransparent<Key, K>>
+        Value get(const K& key){
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        FValueHandle<Value> getHandle(const Key& key) override{
+            FLatencyTimer timer(latency_, FCacheOp::Get);
+            std::lock_guard<std::mutex> lock(mutex_);
+            NodePtr node = findLive(key);
+            if(!node){
+                stats_.record(FStatsCounter::Miss);
+                return nullptr;
+            }
+            FValueHandle<Value> handle = node->getHandle();
+            updateAccessCount(node);
+            stats_.record(FStatsCounter::Hit);
+            return handle;
+        }
+
+        size_t getMany(FSpan<const Key> keys, FSpan<Value> values, FSpan<bool> hits) override{
+            keys = this->batchKeys(keys, values, hits);
+            FLatencyTimer timer(latency_, FCacheOp::Get);
+            std::lock_guard<std::mutex> lock(mutex_);
+            size_t hitCount = 0;
+            for(size_t i = 0; i < keys.size(); ++i){
+                hits[i] = getInternal(keys[i], values[i]);
+                if(hits[i]) hitCount++;
+            }
+            return hitCount;
+        }
+
+        void putMany(FSpan<const Key> keys, FSpan<const Value> values) override{
+            keys = keys.first(values.size());
+            FLatencyTimer timer(latency_, FCacheOp::Put);
+            std::lock_guard<std::mutex> lock(mutex_);
+            expireEntries();
+            for(size_t i = 0; i < keys.size(); ++i)
+                putInternal(0, keys[i], values[i]);
+        }
+
+        // 回收所有已过期的条目
+        void tick(){
+            std::lock_guard<std::mutex> lock(mutex_);
+            expireEntries();
+        }
+
+        // 当前所有条目的权重之和，未给weigher时即条目数；已过期但尚未回收的条目也计算在内
+        size_t weightedSize(){
+            std::lock_guard<std::mutex> lock(mutex_);
+            return weightedSize_;
+        }
+
+        FCacheStats stats() override{
+            return stats_.snapshot(weightedSize());
+        }
+
+        FLatencyHistogram latency(FCacheOp op) override{
+            FLatencyHistogram histogram;
+            latency_.mergeInto(op, histogram);
+            return histogram;
+        }
 
     private:
-        void clearAccessCount(){
-            if(nodeMap_.empty()) return;
-            currentAverageAccess_ = totalAccessCount_ / nodeMap_.size();
-            if(currentAverageAccess_ >= maxAverageAccess_){
-                for(auto it = nodeMap_.begin(); it != nodeMap_.end(); it++){
-                   if(!it->second) continue;
-                   NodePtr node = it->second;
-                   size_t oldFreq = node->getAccessCount();
-                    freqMap_[oldFreq]->removeNode(node);
-                    int newFreq = oldFreq - maxAverageAccess_ / 2;
-                    if(newFreq <= 0) newFreq = 1;
-                    node->accessCount = newFreq;
-                    if(freqMap_.find(newFreq) == freqMap_.end())
-                        freqMap_[newFreq] = new FreqList<Key,Value>(newFreq);
-                    freqMap_[newFreq]->addToFront(node);
-                    totalAccessCount_ -= (oldFreq - newFreq);
-                }
+        friend class FHashLfuCache<Key, Value>;
+
+        template<typename K>
+        bool getInternal(const K& key, Value& value){
+            NodePtr node = findLive(key);
+            if(node){
+                value = node->getValue();
+                updateAccessCount(node);
+                stats_.record(FStatsCounter::Hit);
+                return true;
+            }
+            stats_.record(FStatsCounter::Miss);
+            return false;
+        }
+
+        template<typename K>
+        NodePtr findLive(const K& key){
+            NodePtr node = nodeMap_.find(key);
+            if(node && isExpired(node)){
+                expireNode(node);
+                return nullptr;
+            }
+            return node;
+        }
+
+        // 返回本缓存加权大小的变化量（含写入触发的淘汰，不含过期回收），供FHashLfuCache维护全局容量。
+        // expireAt为0表示不过期
+        template<typename K, typename... Args>
+        std::ptrdiff_t putInternal(uint64_t expireAt, K&& key, Args&&... args){
+            size_t oldSize = weightedSize_;
+            NodePtr node = nodeMap_.find(key);
+            if(node){
+                node->setValue(std::forward<Args>(args)...);
+                reweigh(node);
+                setExpireAt(node, expireAt);
+                updateAccessCount(node);
+                stats_.record(FStatsCounter::Update);
+                while(weightedSize_ > capacity_)
+                    evictLeastFrequent();
+            }else{
+                addNewNode(expireAt, std::forward<K>(key), std::forward<Args>(args)...);
             }
-            currentAverageAccess_ = totalAccessCount_/nodeMap_.size();
-            updateMinFreq();
+            return static_cast<std::ptrdiff_t>(weightedSize_) - static_cast<std::ptrdiff_t>(oldSize);
         }
 
-        void updateMinFreq(){
-            minFreq_ = INT8_MAX;
-            for (const auto& pair : freqMap_)
-            {
-                if (pair.second && !pair.second->empty())
-                {
-                    minFreq_ = std::min(minFreq_, pair.first);
+        template<typename K, typename... Args>
+        std::ptrdiff_t putAndCount(uint64_t expireAt, K&& key, Args&&... args){
+            FLatencyTimer timer(latency_, FCacheOp::Put);
+            std::lock_guard<std::mutex> lock(mutex_);
+            expireEntries();
+            return putInternal(expireAt, std::forward<K>(key), std::forward<Args>(args)...);
+        }
+
+        size_t getManyIndexed(FSpan<const Key> keys, FSpan<Value> values, FSpan<bool> hits,
+                              FSpan<const size_t> indices){
+            FLatencyTimer timer(latency_, FCacheOp::Get);
+            std::lock_guard<std::mutex> lock(mutex_);
+            size_t hitCount = 0;
+            for(size_t i : indices){
+                hits[i] = getInternal(keys[i], values[i]);
+                if(hits[i]) hitCount++;
+            }
+            return hitCount;
+        }
+
+        std::ptrdiff_t putManyIndexed(FSpan<const Key> keys, FSpan<const Value> values, FSpan<const size_t> indices){
+            FLatencyTimer timer(latency_, FCacheOp::Put);
+            std::lock_guard<std::mutex> lock(mutex_);
+            expireEntries();
+            std::ptrdiff_t delta = 0;
+            for(size_t i : indices)
+                delta += putInternal(0, keys[i], values[i]);
+            return delta;
+        }
+
+        // 返回被淘汰条目的权重，没有可淘汰的条目时返回0
+        size_t evictOne(){
+            std::lock_guard<std::mutex> lock(mutex_);
+            if(nodeMap_.empty()) return 0;
+            size_t oldSize = weightedSize_;
+            evictLeastFrequent();
+            return oldSize - weightedSize_;
+        }
+
+        // 所有频次整体减去maxAverageAccess_/2，减到1及以下的频次链表合并进频次1的链表。
+        // 频次链整体有序，只需逐个链表调整频次，合并时才需要更新被搬动节点的所属链表。
+        void clearAccessCount(){
+            FLatencyTimer timer(latency_, FCacheOp::Maintain);
+            stats_.record(FStatsCounter::AgingPass);
+            size_t decay = maxAverageAccess_ / 2;
+            if(decay == 0) decay = 1;
+            FreqListType* baseList = nullptr;
+            FreqListType* list = minFreqList_;
+            while(list){
+                FreqListType* nextList = list->nextList_;
+                size_t newFreq = list->freq_ > decay + 1 ? list->freq_ - decay : 1;
+                totalAccessCount_ -= (list->freq_ - newFreq) * list->size_;
+                list->freq_ = newFreq;
+                if(newFreq == 1){
+                    if(!baseList){
+                        baseList = list;
+                    }else{
+                        baseList->spliceFront(*list); // 原频次更高的节点排在前面，更晚被淘汰
+                        removeFreqList(list);
+                    }
                 }
+                list = nextList;
             }
-            if (minFreq_ == INT8_MAX)
-                minFreq_ = 1;
         }
+
         void evictLeastFrequent(){
-            auto it = freqMap_.find(minFreq_);
-            if(it == freqMap_.end())
+            FreqListType* list = minFreqList_;
+            if(!list) return;
+            if(list->empty()){
+                removeFreqList(list);
                 return;
-            auto node = freqMap_[minFreq_]->removeLast();
-            if(node){
-                nodeMap_.erase(node->getKey());
-                totalAccessCount_ -= minFreq_;
             }
-            if(freqMap_[minFreq_]->empty()){
-                freqMap_.erase(minFreq_);
-                minFreq_ = 1; // Put
+            FLatencyTimer timer(latency_, FCacheOp::Evict);
+            removeEntry(list->tail_.prev);
+            stats_.record(FStatsCounter::Eviction);
+        }
+
+        void removeEntry(NodePtr node){
+            FreqListType* list = node->list;
+            if(timerWheel_)
+                timerWheel_->deschedule(node);
+            list->removeNode(node);
+            nodeMap_.erase(node->getKey());
+            totalAccessCount_ -= list->freq_;
+            weightedSize_ -= node->weight;
+            pool_.deallocate(node);
+            if(list->empty())
+                removeFreqList(list);
+        }
+
+        // 过期回收不经过putInternal的返回值，全局容量模式下直接扣减FHashLfuCache的共享计数
+        void expireNode(NodePtr node){
+            size_t weight = node->weight;
+            removeEntry(node);
+            stats_.record(FStatsCounter::Expiration);
+            if(sharedSize_)
+                sharedSize_->fetch_sub(weight, std::memory_order_relaxed);
+        }
+
+        void setExpireAt(NodePtr node, uint64_t expireAt){
+            node->expireAt = expireAt;
+            if(expireAt){
+                if(!timerWheel_)
+                    timerWheel_.reset(new TimerWheel(TimerWheel::now()));
+                timerWheel_->schedule(node);
+            }else if(timerWheel_){
+                timerWheel_->deschedule(node);
             }
         }
-        void addNewNode(const Key& key, const Value& value){
-            NodePtr node = std::make_shared<NodeType>(key, value);
-            nodeMap_[key] = node;
-            size_t freq = node->getAccessCount();
-            if(freqMap_.find(freq) == freqMap_.end())
-                freqMap_[freq] = new FreqList<Key,Value>(freq);
-            freqMap_[freq] ->addToFront(node);
-            minFreq_ = 1;
+
+        static bool isExpired(NodePtr node){
+            return node->expireAt && node->expireAt <= TimerWheel::now();
+        }
+
+        void expireEntries(){
+            if(!timerWheel_) return;
+            FLatencyTimer timer(latency_, FCacheOp::Maintain);
+            timerWheel_->advance(TimerWheel::now(), [this](NodePtr node){ expireNode(node); });
         }
+
+        template<typename K, typename... Args>
+        void addNewNode(uint64_t expireAt, K&& key, Args&&... args){
+            NodePtr node = pool_.allocate(std::forward<K>(key), std::forward<Args>(args)...);
+            node->weight = weigh(node);
+            if(node->weight > capacity_){ // 单个条目超出总预算，不缓存
+                pool_.deallocate(node);
+                return;
+            }
+            // 先淘汰再插入，否则新条目频次为1，可能刚插入就被淘汰
+            while(weightedSize_ + node->weight > capacity_)
+                evictLeastFrequent();
+            weightedSize_ += node->weight;
+            nodeMap_.insert(node);
+            if(!minFreqList_ || minFreqList_->freq_ != 1)
+                insertFreqListAfter(nullptr, 1);
+            minFreqList_->addToFront(node);
+            totalAccessCount_++;
+            setExpireAt(node, expireAt);
+            stats_.record(FStatsCounter::Put);
+        }
+
+        size_t weigh(NodePtr node) const{
+            return weigher_ ? weigher_(node->getKey(), node->getValue()) : 1;
+        }
+
+        void reweigh(NodePtr node){
+            size_t weight = weigh(node);
+            weightedSize_ = weightedSize_ - node->weight + weight;
+            node->weight = weight;
+        }
+
         void updateAccessCount(NodePtr node){
-            size_t oldFreq = node->getAccessCount();
-            freqMap_[oldFreq] ->removeNode(node);
-            node->incrementAccessCount();
+            FreqListType* oldList = node->list;
+            size_t newFreq = oldList->freq_ + 1;
+            FreqListType* newList = oldList->nextList_;
+            if(!newList || newList->freq_ != newFreq)
+                newList = insertFreqListAfter(oldList, newFreq);
+            oldList->removeNode(node);
+            newList->addToFront(node);
+            if(oldList->empty())
+                removeFreqList(oldList);
             totalAccessCount_++;
-            size_t newFreq = node->getAccessCount();
-            if(minFreq_ == oldFreq && freqMap_[minFreq_]->empty()){
-                freqMap_.erase(minFreq_);
-                minFreq_ = newFreq;
-            }
-            if(freqMap_.find(newFreq) == freqMap_.end())
-                freqMap_[newFreq] = new FreqList<Key, Value>(newFreq);
-            freqMap_[newFreq] -> addToFront(node);
-            if(!nodeMap_.empty()) currentAverageAccess_ = totalAccessCount_ / nodeMap_.size();
-            if(currentAverageAccess_ >= maxAverageAccess_)
+            if(!nodeMap_.empty() && totalAccessCount_ / nodeMap_.size() >= maxAverageAccess_)
                 clearAccessCount();
         }
 
+        // prev为nullptr时插入到频次链最前面
+        FreqListType* insertFreqListAfter(FreqListType* prev, size_t freq){
+            FreqListType* list = listPool_.allocate(freq);
+            FreqListType* next = prev ? prev->nextList_ : minFreqList_;
+            list->prevList_ = prev;
+            list->nextList_ = next;
+            if(next) next->prevList_ = list;
+            if(prev) prev->nextList_ = list;
+            else minFreqList_ = list;
+            return list;
+        }
+
+        void removeFreqList(FreqListType* list){
+            if(list->prevList_) list->prevList_->nextList_ = list->nextList_;
+            else minFreqList_ = list->nextList_;
+            if(list->nextList_) list->nextList_->prevList_ = list->prevList_;
+            listPool_.deallocate(list);
+        }
+
         size_t capacity_;
+        size_t weightedSize_;
+        FWeigher<Key, Value> weigher_;
+        FNodePool<NodeType> pool_;
+        FNodePool<FreqListType> listPool_;
         NodeMap nodeMap_;
-        std::unordered_map<size_t, FreqList<Key,Value>*> freqMap_;
-        size_t minFreq_;
+        FreqListType* minFreqList_; // 频次链表头，即当前最小频次
 
-        size_t totalAccessCount_;
-        size_t currentAverageAccess_;
+        size_t totalAccessCount_; // 所有条目访问频次之和
         size_t maxAverageAccess_;
+        std::unique_ptr<TimerWheel> timerWheel_;
+        std::atomic<size_t>* sharedSize_; // 全局容量模式下指向FHashLfuCache::size_
+        FStatsCounter stats_;
+        FLatencyRecorder latency_;
 
         std::mutex mutex_;
     };
+
+    // 按key哈希分片的LFU，老化与淘汰都在各分片内部独立进行。
+    // globalCapacity为true时各分片不再按capacity/N硬切分，而是共享一个全局的加权大小计数，
+    // 超出总容量时按轮转顺序从各分片淘汰其最不常用的条目，使容量随key的倾斜分布流动。
+    template<typename Key, typename Value>
+    class FHashLfuCache: public FICachePolicy<Key, Value>{
+    public:
+        explicit FHashLfuCache(size_t capacity, size_t sliceNum = 0,
+                               int maxAverageAccess = 10, bool globalCapacity = false,
+                               FWeigher<Key, Value> weigher = nullptr)
+        : capacity_(capacity)
+        , sliceNum_(sliceNum > 0 ? sliceNum : defaultSliceNum(capacity))
+        , globalCapacity_(globalCapacity)
+        , size_(0)
+        , evictCursor_(0){
+            size_t sliceSize = globalCapacity_ ? capacity_ : (capacity_ + sliceNum_ - 1) / sliceNum_;
+            for(size_t i = 0; i < sliceNum_; ++i){
+                lfuSliceCaches_.emplace_back(new FLfuCache<Key, Value>(sliceSize, maxAverageAccess, weigher));
+                if(globalCapacity_)
+                    lfuSliceCaches_.back()->sharedSize_ = &size_;
+            }
+        }
+
+        size_t weightedSize(){
+            if(globalCapacity_)
+                return size_.load(std::memory_order_relaxed);
+            size_t size = 0;
+            for(auto& slice : lfuSliceCaches_)
+                size += slice->weightedSize();
+            return size;
+        }
+
+        ~FHashLfuCache() override = default;
+
+        void put(const Key& key, const Value& value) override{
+            putToSlice(0, key, value);
+        }
+
+        void put(Key key, Value&& value) override{
+            putToSlice(0, std::move(key), std::move(value));
+        }
+
+        void put(const Key& key, const Value& value, std::chrono::nanoseconds ttl){
+            putToSlice(FTimerWheel<typename FLfuCache<Key, Value>::NodeType>::deadline(ttl), key, value);
+        }
+
+        void put(Key key, Value&& value, std::chrono::nanoseconds ttl){
+            putToSlice(FTimerWheel<typename FLfuCache<Key, Value>::NodeType>::deadline(ttl),
+                       std::move(key), std::move(value));
+        }
+
+        template<typename... Args>
+        void emplace(const Key& key, Args&&... args){
+            putToSlice(0, key, std::forward<Args>(args)...);
+        }
+
+        void tick(){
+            for(auto& slice : lfuSliceCaches_)
+                slice->tick();
+        }
+
+        FCacheStats stats() override{
+            FCacheStats stats;
+            for(auto& slice : lfuSliceCaches_)
+                stats += slice->stats();
+            stats.size = weightedSize();
+            return stats;
+        }
+
+        FLatencyHistogram latency(FCacheOp op) override{
+            FLatencyHistogram histogram;
+            for(auto& slice : lfuSliceCaches_)
+                slice->latency_.mergeInto(op, histogram);
+            return histogram;
+        }
+
+        bool get(const Key& key, Value& value) override{
+            return getSlice(key).get(key, value);
+        }
+
+        Value get(const Key& key) override{
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        template<typename K, typename = FEnableTransparent<Key, K>>
+        bool get(const K& key, Value& value){
+            return getSlice(key).get(key, value);
+        }
+
+        template<typename K, typename = FEnableTransparent<Key, K>>
+        Value get(const K& key){
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        FValueHandle<Value> getHandle(const Key& key) override{
+            return getSlice(key).getHandle(key);
+        }
+
+        // 各分片分别计一次批量延迟
+        size_t getMany(FSpan<const Key> keys, FSpan<Value> values, FSpan<bool> hits) override{
+            keys = this->batchKeys(keys, values, hits);
+            FSliceBatch batch(keys, sliceNum_, [this](const Key& key){ return sliceIndex(key); });
+            size_t hitCount = 0;
+            for(size_t s = 0; s < sliceNum_; ++s){
+                FSpan<const size_t> indices = batch.indices(s);
+                if(!indices.empty())
+                    hitCount += lfuSliceCaches_[s]->getManyIndexed(keys, values, hits, indices);
+            }
+            return hitCount;
+        }
+
+        // 全局容量模式下先在各分片内写完，释放分片锁后再按加权大小的净变化统一淘汰
+        void putMany(FSpan<const Key> keys, FSpan<const Value> values) override{
+            keys = keys.first(values.size());
+            FSliceBatch batch(keys, sliceNum_, [this](const Key& key){ return sliceIndex(key); });
+            for(size_t s = 0; s < sliceNum_; ++s){
+                FSpan<const size_t> indices = batch.indices(s);
+                if(!indices.empty())
+                    applyGlobalDelta(lfuSliceCaches_[s]->putManyIndexed(keys, values, indices));
+            }
+        }
+
+    private:
+        static size_t defaultSliceNum(size_t capacity){
+            size_t sliceNum = std::thread::hardware_concurrency();
+            if(sliceNum == 0) sliceNum = 1;
+            if(capacity > 0 && sliceNum > capacity) sliceNum = capacity;
+            return sliceNum;
+        }
+
+        template<typename K>
+        size_t sliceIndex(const K& key) const{
+            return FHash<Key>{}(key) % sliceNum_;
+        }
+
+        template<typename K>
+        FLfuCache<Key, Value>& getSlice(const K& key){
+            return *lfuSliceCaches_[sliceIndex(key)];
+        }
+
+        template<typename K, typename... Args>
+        void putToSlice(uint64_t expireAt, K&& key, Args&&... args){
+            FLfuCache<Key, Value>& slice = getSlice(key);
+            applyGlobalDelta(slice.putAndCount(expireAt, std::forward<K>(key), std::forward<Args>(args)...));
+        }
+
+        // 调用时不能持有任何分片的锁
+        void applyGlobalDelta(std::ptrdiff_t delta){
+            if(!globalCapacity_ || delta == 0) return;
+            size_t size = size_.fetch_add(static_cast<size_t>(delta), std::memory_order_relaxed)
+                          + static_cast<size_t>(delta);
+            while(size > capacity_){
+                if(evictFromAnySlice() == 0) return;
+                size = size_.load(std::memory_order_relaxed);
+            }
+        }
+
+        size_t evictFromAnySlice(){
+            for(size_t i = 0; i < sliceNum_; ++i){
+                size_t index = evictCursor_.fetch_add(1, std::memory_order_relaxed) % sliceNum_;
+                size_t freed = lfuSliceCaches_[index]->evictOne();
+                if(freed > 0){
+                    size_.fetch_sub(freed, std::memory_order_relaxed);
+                    return freed;
+                }
+            }
+            return 0;
+        }
+
+        size_t capacity_;
+        size_t sliceNum_;
+        bool globalCapacity_;
+        std::atomic<size_t> size_;
+        std::atomic<size_t> evictCursor_;
+        std::vector<std::unique_ptr<FLfuCache<Key, Value>>> lfuSliceCaches_;
+    };
 }
 
 #endif //FULINCACHE_FLFUCACHE_H
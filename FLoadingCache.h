@@ -0,0 +1,75 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+
+#ifndef FULINCACHE_FLOADINGCACHE_H
+#define FULINCACHE_FLOADINGCACHE_H
+#include <future>
+#include <mutex>
+#include <unordered_map>
+#include <exception>
+#include <utility>
+
+#include "FICachePolicy.h"
+#include "FHash.h"
+
+namespace FulinCache {
+    // 在任意FICachePolicy之上提供getOrLoad：未命中时同一个key同时只有一个调用方执行loader，
+    // 其余并发未命中的调用方等待同一个shared_future，加载完成后写入缓存并共享结果。
+    // 热点key被淘汰时后端只收到一次请求，而不是每个并发读者各一次。
+    // 不持有cache，调用方需保证cache的生命周期长于本对象。
+    template<typename Key, typename Value>
+    class FLoadingCache {
+    public:
+        explicit FLoadingCache(FICachePolicy<Key, Value>& cache): cache_(cache){}
+
+        FLoadingCache(const FLoadingCache&) = delete;
+        FLoadingCache& operator=(const FLoadingCache&) = delete;
+
+        // loader为无参可调用对象，返回Value。loader抛出的异常会传给所有等待该key的调用方，
+        // 结果不写入缓存，下一次getOrLoad重新加载。loader内不能对同一个key再调用getOrLoad，否则死锁
+        template<typename Loader>
+        Value getOrLoad(const Key& key, Loader&& loader){
+            Value value{};
+            if(cache_.get(key, value))
+                return value;
+
+            std::promise<Value> promise;
+            std::shared_future<Value> future;
+            std::unique_lock<std::mutex> lock(mutex_);
+            auto it = inFlight_.find(key);
+            if(it != inFlight_.end()){
+                future = it->second;
+                lock.unlock();
+                return future.get();
+            }
+            // 上一个加载者可能在我们查缓存之后刚写入并移出inFlight_，加锁后再查一次
+            if(cache_.get(key, value))
+                return value;
+            future = promise.get_future().share();
+            inFlight_.emplace(key, future);
+            lock.unlock();
+
+            try{
+                Value loaded = loader();
+                // 先写缓存再移出inFlight_，之后到达的调用方要么命中缓存，要么等到同一个future
+                cache_.put(key, loaded);
+                promise.set_value(std::move(loaded));
+            }catch(...){
+                promise.set_exception(std::current_exception());
+            }
+            lock.lock();
+            inFlight_.erase(key);
+            lock.unlock();
+            return future.get();
+        }
+
+    private:
+        FICachePolicy<Key, Value>& cache_;
+        std::unordered_map<Key, std::shared_future<Value>, FHash<Key>> inFlight_; // 正在加载的key
+        std::mutex mutex_;
+    };
+
+} // FulinCache
+
+#endif //FULINCACHE_FLOADINGCACHE_H
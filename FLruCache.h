@@ -5,90 +5,462 @@
 #ifndef FULINCACHE_FLRUCACHE_H
 #define FULINCACHE_FLRUCACHE_H
 #include<memory>
-#include<unordered_map>
+#include <algorithm>
 #include <mutex>
+#include <shared_mutex>
+#include <vector>
+#include <thread>
 #include "FICachePolicy.h"
+#include "FNodePool.h"
+#include "FFlatMap.h"
+#include "FReadBuffer.h"
+#include "FSliceBatch.h"
+#include "FTimerWheel.h"
 
 namespace FulinCache {
     template<typename Key, typename Value> class FLruCache;
+    template<typename Key, typename Value> class FHashLruCache;
 
     template <typename Key, typename Value>
     class LruNode{
     public:
-        explicit LruNode(Key key, Value value):
-        key_(key), value_(value),accessCount(1),next(nullptr), prev(){}
+        LruNode(): accessCount(1), key_(), value_(), weight(1), expireAt(0),
+        next(nullptr), prev(nullptr), timerPrev(nullptr), timerNext(nullptr){}
+        // args直接用于构造value
+        template<typename K, typename... Args>
+        explicit LruNode(K&& key, Args&&... args):
+        accessCount(1), key_(std::forward<K>(key)), value_(std::in_place, std::forward<Args>(args)...),
+        weight(1), expireAt(0),
+        next(nullptr), prev(nullptr), timerPrev(nullptr), timerNext(nullptr){}
 
-        Value getValue() const {return value_;}
-        Key getKey() const {return key_;}
-        void setValue(const Value& value) {value_ = value;}
+        const Value& getValue() const {return value_.get();}
+        FValueHandle<Value> getHandle() const {return value_.handle();}
+        const Key& getKey() const {return key_;}
+        template<typename... Args>
+        void setValue(Args&&... args) {value_.set(std::forward<Args>(args)...);}
         size_t getAccessCount() const {return accessCount;}
         void incrementAccessCount() {accessCount++;}
 
         friend class FLruCache<Key,Value>;
+        friend class FTimerWheel<LruNode<Key,Value>>;
     private:
         size_t accessCount;
         Key key_;
-        Value value_;
-        std::shared_ptr<LruNode<Key,Value>> next;
-        std::weak_ptr<LruNode<Key, Value>> prev;
+        FValueSlot<Value> value_;
+        size_t weight;
+        uint64_t expireAt; // 过期时间，0表示不过期
+        LruNode<Key,Value>* next;
+        LruNode<Key,Value>* prev;
+        LruNode<Key,Value>* timerPrev;
+        LruNode<Key,Value>* timerNext;
     };
 
     template<typename Key, typename Value>
     class FLruCache: public FICachePolicy<Key, Value>{
     public:
         using LruNodeType = LruNode<Key,Value>;
-        using NodePtr = std::shared_ptr<LruNodeType>;
-        using NodeMap = std::unordered_map<Key,NodePtr>;
+        using NodePtr = LruNodeType*;
+        using NodeMap = FFlatMap<Key, LruNodeType>;
+        using TimerWheel = FTimerWheel<LruNodeType>;
 
-        explicit FLruCache(int capacity): capacity_(capacity){
+        // bufferedPromotion为true时，命中只在共享锁下查表并把节点记录到读缓冲，
+        // 移到链表头的操作在缓冲写满（try-lock）或下一次写操作时批量回放，访问顺序为近似LRU。
+        // 给出weigher时capacity是总权重预算，插入时从链表尾淘汰直到放得下新条目
+        explicit FLruCache(size_t capacity, bool bufferedPromotion = false, FWeigher<Key, Value> weigher = nullptr)
+        : capacity_(capacity)
+        , weightedSize_(0)
+        , weigher_(std::move(weigher))
+        , readBuffer_(bufferedPromotion ? new FReadBuffer<LruNodeType>() : nullptr){
             initializeCache();
         }
 
-        ~FLruCache() override =default;
-
-        bool get(Key key, Value& value) override{
-            std::lock_guard<std::mutex> lock(mutex_);
-            auto it = nodeMap_.find(key);
-            if(it != nodeMap_.end()){
-                value = it->second->getValue();
-                updateAccessCount(it->second);
-                return true;
+        ~FLruCache() override{
+            NodePtr node = head_;
+            while(node){
+                NodePtr next = node->next;
+                pool_.deallocate(node);
+                node = next;
             }
-            return false;
         }
 
-        Value get(Key key) override{
+        bool get(const Key& key, Value& value) override{
+            return getImpl(key, value);
+        }
+
+        Value get(const Key& key) override{
             Value value{};
             get(key, value);
             return value;
         }
 
-        void put(Key key, Value value) override{
-            std::lock_guard<std::mutex> lock(mutex_);
-            auto it = nodeMap_.find(key);
-            if(it != nodeMap_.end()){
-                it->second->setValue(value);
-                updateAccessCount(it->second);
-                return;
+        // 以可与Key比较的其他类型查找（如Key为std::string时传string_view），不构造临时Key，见FHash
+        template<typename K, typename = FEnableTransparent<Key, K>>
+        bool get(const K& key, Value& value){
+            return getImpl(key, value);
+        }
+
+        template<typename K, typename = FEnableTransparent<Key, K>>
+        Value get(const K& key){
+            Value value{};
+            getImpl(key, value);
+            return value;
+        }
+
+        FValueHandle<Value> getHandle(const Key& key) override{
+            FLatencyTimer timer(latency_, FCacheOp::Get);
+            FValueHandle<Value> handle;
+            if(readBuffer_){
+                getBuffered(key, [&handle](NodePtr node){ handle = node->getHandle(); });
+                return handle;
             }
-            if(capacity_ <= nodeMap_.size())
-                removeLastNode();
-            addNewNode(key, value);
+            std::lock_guard<std::shared_mutex> lock(mutex_);
+            NodePtr node = findLive(key);
+            if(node){
+                handle = node->getHandle();
+                updateAccessCount(node);
+            }
+            stats_.record(node ? FStatsCounter::Hit : FStatsCounter::Miss);
+            return handle;
+        }
+
+        void put(const Key& key, const Value& value) override{
+            FLatencyTimer timer(latency_, FCacheOp::Put);
+            std::lock_guard<std::shared_mutex> lock(mutex_);
+            drainReadBuffer();
+            expireEntries();
+            putLocked(0, key, value);
+        }
+
+        void put(Key key, Value&& value) override{
+            FLatencyTimer timer(latency_, FCacheOp::Put);
+            std::lock_guard<std::shared_mutex> lock(mutex_);
+            drainReadBuffer();
+            expireEntries();
+            putLocked(0, std::move(key), std::move(value));
+        }
+
+        // 条目在ttl后过期：get时发现过期即删除，写操作与tick()时由时间轮回收，不扫描nodeMap_。
+        // 不带ttl的put会清除已有条目的过期时间
+        void put(const Key& key, const Value& value, std::chrono::nanoseconds ttl){
+            FLatencyTimer timer(latency_, FCacheOp::Put);
+            std::lock_guard<std::shared_mutex> lock(mutex_);
+            drainReadBuffer();
+            expireEntries();
+            putLocked(TimerWheel::deadline(ttl), key, value);
+        }
+
+        void put(Key key, Value&& value, std::chrono::nanoseconds ttl){
+            FLatencyTimer timer(latency_, FCacheOp::Put);
+            std::lock_guard<std::shared_mutex> lock(mutex_);
+            drainReadBuffer();
+            expireEntries();
+            putLocked(TimerWheel::deadline(ttl), std::move(key), std::move(value));
+        }
+
+        // 用args在节点内直接构造value
+        template<typename... Args>
+        void emplace(const Key& key, Args&&... args){
+            FLatencyTimer timer(latency_, FCacheOp::Put);
+            std::lock_guard<std::shared_mutex> lock(mutex_);
+            drainReadBuffer();
+            expireEntries();
+            putLocked(0, key, std::forward<Args>(args)...);
+        }
+
+        size_t getMany(FSpan<const Key> keys, FSpan<Value> values, FSpan<bool> hits) override{
+            keys = this->batchKeys(keys, values, hits);
+            FLatencyTimer timer(latency_, FCacheOp::Get);
+            std::lock_guard<std::shared_mutex> lock(mutex_);
+            drainReadBuffer();
+            return getBatchLocked(keys, values, hits, keys.size(), [](size_t j){ return j; });
+        }
+
+        // 与getMany同样整批只加一次锁，但逐个key查表、不做预取。
+        // 供基准对照，把预取重叠cache miss的收益与锁的摊销分开衡量
+        size_t getManyNoPrefetch(FSpan<const Key> keys, FSpan<Value> values, FSpan<bool> hits){
+            keys = this->batchKeys(keys, values, hits);
+            FLatencyTimer timer(latency_, FCacheOp::Get);
+            std::lock_guard<std::shared_mutex> lock(mutex_);
+            drainReadBuffer();
+            return getBatchLocked<false>(keys, values, hits, keys.size(), [](size_t j){ return j; });
+        }
+
+        void putMany(FSpan<const Key> keys, FSpan<const Value> values) override{
+            keys = keys.first(values.size());
+            FLatencyTimer timer(latency_, FCacheOp::Put);
+            std::lock_guard<std::shared_mutex> lock(mutex_);
+            drainReadBuffer();
+            expireEntries();
+            for(size_t i = 0; i < keys.size(); ++i)
+                putLocked(0, keys[i], values[i]);
+        }
+
+        // 只判断是否存在，不更新访问顺序
+        bool contains(const Key& key){
+            return containsImpl(key);
+        }
+
+        template<typename K, typename = FEnableTransparent<Key, K>>
+        bool contains(const K& key){
+            return containsImpl(key);
+        }
+
+        void remove(const Key& key){
+            std::lock_guard<std::shared_mutex> lock(mutex_);
+            drainReadBuffer();
+            NodePtr node = nodeMap_.find(key);
+            if(node)
+                eraseNode(node);
+        }
+
+        // 回收所有已过期的条目，供没有写流量时由后台线程定期调用
+        void tick(){
+            std::lock_guard<std::shared_mutex> lock(mutex_);
+            drainReadBuffer();
+            expireEntries();
+        }
+
+        // 当前所有条目的权重之和，未给weigher时即条目数；已过期但尚未回收的条目也计算在内
+        size_t weightedSize(){
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            return weightedSize_;
+        }
+
+        FCacheStats stats() override{
+            return stats_.snapshot(weightedSize());
+        }
+
+        FLatencyHistogram latency(FCacheOp op) override{
+            FLatencyHistogram histogram;
+            latency_.mergeInto(op, histogram);
+            return histogram;
         }
 
     private:
+        friend class FHashLruCache<Key, Value>;
+
+        template<typename K>
+        bool getImpl(const K& key, Value& value){
+            FLatencyTimer timer(latency_, FCacheOp::Get);
+            if(readBuffer_)
+                return getBuffered(key, [&value](NodePtr node){ value = node->getValue(); });
+            std::lock_guard<std::shared_mutex> lock(mutex_);
+            return getLocked(key, value);
+        }
+
+        template<typename K>
+        bool containsImpl(const K& key){
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            NodePtr node = nodeMap_.find(key);
+            return node && !isExpired(node);
+        }
+
+        // 只处理indices指定的那部分key，供FHashLruCache按分片分组后调用
+        size_t getManyIndexed(FSpan<const Key> keys, FSpan<Value> values, FSpan<bool> hits,
+                              FSpan<const size_t> indices){
+            FLatencyTimer timer(latency_, FCacheOp::Get);
+            std::lock_guard<std::shared_mutex> lock(mutex_);
+            drainReadBuffer();
+            return getBatchLocked(keys, values, hits, indices.size(), [&indices](size_t j){ return indices[j]; });
+        }
+
+        // 每kPrefetchBatch个key一组分四趟：算哈希并预取探测组；只比较标签并预取匹配的节点；
+        // 比较key完成查表并预取节点的前后邻居；最后读值并移到链表头。
+        // 探测组、节点、邻居三层内存访问各自在整组key间重叠，而不是逐个key串行等待。
+        // Prefetch为false时每组只有一个key且不预取，退化为逐个查找
+        template<bool Prefetch = true, typename IndexOf>
+        size_t getBatchLocked(FSpan<const Key> keys, FSpan<Value> values, FSpan<bool> hits,
+                              size_t count, IndexOf indexOf){
+            constexpr size_t groupSize = Prefetch ? kPrefetchBatch : 1;
+            size_t hashes[groupSize];
+            NodePtr nodes[groupSize];
+            size_t hitCount = 0;
+            for(size_t begin = 0; begin < count; begin += groupSize){
+                size_t end = std::min(count, begin + groupSize);
+                for(size_t j = begin; j < end; ++j){
+                    hashes[j - begin] = nodeMap_.hash(keys[indexOf(j)]);
+                    if(Prefetch) nodeMap_.prefetch(hashes[j - begin]);
+                }
+                if(Prefetch)
+                    for(size_t j = begin; j < end; ++j)
+                        nodeMap_.prefetchNode(hashes[j - begin]);
+                for(size_t j = begin; j < end; ++j){
+                    NodePtr node = nodeMap_.find(keys[indexOf(j)], hashes[j - begin]);
+                    nodes[j - begin] = node;
+                    if(Prefetch && node){
+                        NodeMap::prefetchLine(node->prev);
+                        NodeMap::prefetchLine(node->next);
+                    }
+                }
+                for(size_t j = begin; j < end; ++j){
+                    size_t i = indexOf(j);
+                    NodePtr node = nodes[j - begin];
+                    if(node && isExpired(node)){
+                        // 同一组里可能有重复的key，删除前把后面指向该节点的位置一并清空
+                        for(size_t d = j + 1; d < end; ++d)
+                            if(nodes[d - begin] == node) nodes[d - begin] = nullptr;
+                        eraseNode(node);
+                        stats_.record(FStatsCounter::Expiration);
+                        node = nullptr;
+                    }
+                    hits[i] = node != nullptr;
+                    if(node){
+                        values[i] = node->getValue();
+                        updateAccessCount(node);
+                        hitCount++;
+                    }
+                }
+            }
+            stats_.record(FStatsCounter::Hit, hitCount);
+            stats_.record(FStatsCounter::Miss, count - hitCount);
+            return hitCount;
+        }
+
+        void putManyIndexed(FSpan<const Key> keys, FSpan<const Value> values, FSpan<const size_t> indices){
+            FLatencyTimer timer(latency_, FCacheOp::Put);
+            std::lock_guard<std::shared_mutex> lock(mutex_);
+            drainReadBuffer();
+            expireEntries();
+            for(size_t i : indices)
+                putLocked(0, keys[i], values[i]);
+        }
+
+        // 以下函数要求调用方持有独占锁
+        template<typename K>
+        bool getLocked(const K& key, Value& value){
+            NodePtr node = findLive(key);
+            if(node){
+                value = node->getValue();
+                updateAccessCount(node);
+                stats_.record(FStatsCounter::Hit);
+                return true;
+            }
+            stats_.record(FStatsCounter::Miss);
+            return false;
+        }
+
+        // 查找未过期的节点，发现已过期则顺带删除
+        template<typename K>
+        NodePtr findLive(const K& key){
+            NodePtr node = nodeMap_.find(key);
+            if(node && isExpired(node)){
+                eraseNode(node);
+                stats_.record(FStatsCounter::Expiration);
+                return nullptr;
+            }
+            return node;
+        }
+
+        // expireAt为0表示不过期
+        template<typename K, typename... Args>
+        void putLocked(uint64_t expireAt, K&& key, Args&&... args){
+            NodePtr node = nodeMap_.find(key);
+            if(node){
+                node->setValue(std::forward<Args>(args)...);
+                reweigh(node);
+                setExpireAt(node, expireAt);
+                updateAccessCount(node);
+                stats_.record(FStatsCounter::Update);
+                // 新value变重时淘汰其他条目，单个条目超出预算时自身也会被淘汰
+                while(weightedSize_ > capacity_)
+                    removeLastNode();
+                return;
+            }
+            addNewNode(expireAt, std::forward<K>(key), std::forward<Args>(args)...);
+        }
+
+        // read在共享锁内对命中的节点调用，负责取出value或句柄
+        template<typename K, typename Read>
+        bool getBuffered(const K& key, Read&& read){
+            bool shouldDrain;
+            {
+                std::shared_lock<std::shared_mutex> lock(mutex_);
+                NodePtr node = nodeMap_.find(key);
+                // 共享锁下不能删除，过期节点留给下一次写操作或tick()回收
+                if(!node || isExpired(node)){
+                    stats_.record(FStatsCounter::Miss);
+                    return false;
+                }
+                read(node);
+                stats_.record(FStatsCounter::Hit);
+                // 必须在共享锁内记录：节点只会在独占锁下被淘汰，而淘汰前总会先drain
+                shouldDrain = readBuffer_->record(node);
+            }
+            if(shouldDrain){
+                std::unique_lock<std::shared_mutex> lock(mutex_, std::try_to_lock);
+                if(lock.owns_lock())
+                    drainReadBuffer();
+            }
+            return true;
+        }
+
+        // 调用方需持有独占锁
+        void drainReadBuffer(){
+            if(!readBuffer_) return;
+            FLatencyTimer timer(latency_, FCacheOp::Maintain);
+            readBuffer_->drain([this](NodePtr node){
+                updateAccessCount(node);
+            });
+        }
+
         void initializeCache(){
-            head_ = std::make_shared<LruNodeType>(Key(),Value());
-            tail_ = std::make_shared<LruNodeType>(Key(),Value());
+            head_ = pool_.allocate();
+            tail_ = pool_.allocate();
 
             head_ -> next = tail_;
             tail_ -> prev = head_;
         }
 
-        void addNewNode(const Key& key, const Value& value){
-            NodePtr node = std::make_shared<LruNodeType>(key, value);
-            nodeMap_[key] = node;
+        template<typename K, typename... Args>
+        void addNewNode(uint64_t expireAt, K&& key, Args&&... args){
+            NodePtr node = pool_.allocate(std::forward<K>(key), std::forward<Args>(args)...);
+            node->weight = weigh(node);
+            if(node->weight > capacity_){ // 单个条目超出总预算，不缓存
+                pool_.deallocate(node);
+                return;
+            }
+            while(weightedSize_ + node->weight > capacity_)
+                removeLastNode();
+            nodeMap_.insert(node);
             addToFirst(node);
+            weightedSize_ += node->weight;
+            setExpireAt(node, expireAt);
+            stats_.record(FStatsCounter::Put);
+        }
+
+        // 时间轮在第一次带ttl的写入时才创建，不使用ttl的缓存没有额外开销
+        void setExpireAt(NodePtr node, uint64_t expireAt){
+            node->expireAt = expireAt;
+            if(expireAt){
+                if(!timerWheel_)
+                    timerWheel_.reset(new TimerWheel(TimerWheel::now()));
+                timerWheel_->schedule(node);
+            }else if(timerWheel_){
+                timerWheel_->deschedule(node);
+            }
+        }
+
+        static bool isExpired(NodePtr node){
+            return node->expireAt && node->expireAt <= TimerWheel::now();
+        }
+
+        void expireEntries(){
+            if(!timerWheel_) return;
+            FLatencyTimer timer(latency_, FCacheOp::Maintain);
+            timerWheel_->advance(TimerWheel::now(), [this](NodePtr node){
+                eraseNode(node);
+                stats_.record(FStatsCounter::Expiration);
+            });
+        }
+
+        size_t weigh(NodePtr node) const{
+            return weigher_ ? weigher_(node->getKey(), node->getValue()) : 1;
+        }
+
+        void reweigh(NodePtr node){
+            size_t weight = weigh(node);
+            weightedSize_ = weightedSize_ - node->weight + weight;
+            node->weight = weight;
         }
 
         void updateAccessCount(NodePtr node){
@@ -108,26 +480,310 @@ namespace FulinCache {
         }
 
         void removeNode(NodePtr node){
-            if(!node->prev.expired() && node->next){
-                auto prev = node->prev.lock();
-                prev->next = node->next;
+            if(node->prev && node->next){
+                node->prev->next = node->next;
                 node->next->prev = node->prev;
                 node->next = nullptr;
+                node->prev = nullptr;
             }
         }
         void removeLastNode(){
-            NodePtr node = tail_->prev.lock();
-            if(node&& node!= head_){
-                removeNode(node);
-                nodeMap_.erase(node->getKey());
+            NodePtr node = tail_->prev;
+            if(node && node != head_){
+                FLatencyTimer timer(latency_, FCacheOp::Evict);
+                eraseNode(node);
+                stats_.record(FStatsCounter::Eviction);
             }
         }
 
+        void eraseNode(NodePtr node){
+            if(timerWheel_)
+                timerWheel_->deschedule(node);
+            removeNode(node);
+            nodeMap_.erase(node->getKey());
+            weightedSize_ -= node->weight;
+            pool_.deallocate(node);
+        }
+
+        static constexpr size_t kPrefetchBatch = 16;
+
+        FNodePool<LruNodeType> pool_;
         NodePtr head_;
         NodePtr tail_;
         NodeMap nodeMap_;
-        int capacity_;
-        std::mutex mutex_;
+        size_t capacity_;
+        size_t weightedSize_;
+        FWeigher<Key, Value> weigher_;
+        std::unique_ptr<FReadBuffer<LruNodeType>> readBuffer_;
+        std::unique_ptr<TimerWheel> timerWheel_;
+        FStatsCounter stats_;
+        FLatencyRecorder latency_;
+        std::shared_mutex mutex_;
+    };
+
+    // LRU-K：key在历史队列中累计访问k次后才进入主缓存，避免一次性扫描冲掉热点数据。
+    // 一次请求只计一次访问：get未命中计一次，随后回填同一key的put不再重复计数；
+    // 没有先经过get未命中的put（如只写不读）本身计一次
+    template<typename Key, typename Value>
+    class FLruKCache: public FLruCache<Key, Value>{
+    public:
+        FLruKCache(size_t capacity, size_t historyCapacity, size_t k = 2, FWeigher<Key, Value> weigher = nullptr)
+        : FLruCache<Key, Value>(capacity, false, std::move(weigher))
+        , historyList_(historyCapacity)
+        , k_(k){}
+
+        ~FLruKCache() override = default;
+
+        bool get(const Key& key, Value& value) override{
+            return getImpl(key, value);
+        }
+
+        Value get(const Key& key) override{
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        template<typename K, typename = FEnableTransparent<Key, K>>
+        bool get(const K& key, Value& value){
+            return getImpl(key, value);
+        }
+
+        template<typename K, typename = FEnableTransparent<Key, K>>
+        Value get(const K& key){
+            Value value{};
+            getImpl(key, value);
+            return value;
+        }
+
+        void put(const Key& key, const Value& value) override{
+            if(admit(key))
+                FLruCache<Key, Value>::put(key, value);
+        }
+
+        void put(Key key, Value&& value) override{
+            if(admit(key))
+                FLruCache<Key, Value>::put(std::move(key), std::move(value));
+        }
+
+        void put(const Key& key, const Value& value, std::chrono::nanoseconds ttl){
+            if(admit(key))
+                FLruCache<Key, Value>::put(key, value, ttl);
+        }
+
+        void put(Key key, Value&& value, std::chrono::nanoseconds ttl){
+            if(admit(key))
+                FLruCache<Key, Value>::put(std::move(key), std::move(value), ttl);
+        }
+
+        // 未准入时不构造value
+        template<typename... Args>
+        void emplace(const Key& key, Args&&... args){
+            if(admit(key))
+                FLruCache<Key, Value>::emplace(key, std::forward<Args>(args)...);
+        }
+
+        FValueHandle<Value> getHandle(const Key& key) override{
+            FValueHandle<Value> handle = FLruCache<Key, Value>::getHandle(key);
+            if(!handle)
+                recordMiss(key);
+            return handle;
+        }
+
+        // 准入逻辑依赖历史计数，批量接口退回逐个调用get/put
+        size_t getMany(FSpan<const Key> keys, FSpan<Value> values, FSpan<bool> hits) override{
+            return FICachePolicy<Key, Value>::getMany(keys, values, hits);
+        }
+
+        void putMany(FSpan<const Key> keys, FSpan<const Value> values) override{
+            FICachePolicy<Key, Value>::putMany(keys, values);
+        }
+
+        // 隐藏基类绕过准入的批量查找
+        size_t getManyNoPrefetch(FSpan<const Key> keys, FSpan<Value> values, FSpan<bool> hits){
+            return getMany(keys, values, hits);
+        }
+
+    private:
+        // 只有未命中时才需要构造Key记入历史
+        template<typename K>
+        bool getImpl(const K& key, Value& value){
+            if(FLruCache<Key, Value>::get(key, value))
+                return true;
+            recordMiss(Key(key));
+            return false;
+        }
+
+        // 历史队列中的一项：累计访问次数，以及最近一次访问是否为尚未回填的get未命中
+        struct History {
+            size_t count = 0;
+            bool pendingFill = false;
+        };
+
+        void recordMiss(const Key& key){
+            std::lock_guard<std::mutex> lock(historyMutex_);
+            History history = historyList_.get(key);
+            history.count++;
+            history.pendingFill = true;
+            historyList_.put(key, history);
+        }
+
+        // 已在主缓存中或历史计数达到k时返回true。紧跟在get未命中之后的回填不再计数，否则本次写入计一次访问
+        bool admit(const Key& key){
+            std::lock_guard<std::mutex> lock(historyMutex_);
+            if(FLruCache<Key, Value>::contains(key))
+                return true;
+            History history = historyList_.get(key);
+            if(history.pendingFill)
+                history.pendingFill = false;
+            else
+                history.count++;
+            if(history.count >= k_){
+                historyList_.remove(key);
+                return true;
+            }
+            historyList_.put(key, history);
+            return false;
+        }
+
+        FLruCache<Key, History> historyList_; // 只记录访问次数，不保存未准入的value
+        size_t k_;
+        std::mutex historyMutex_; // 历史计数的读-改-写需整体互斥，否则并发未命中会丢失计数
+    };
+
+    // 按key哈希分片的LRU，每个分片是独立加锁的FLruCache
+    template<typename Key, typename Value>
+    class FHashLruCache: public FICachePolicy<Key, Value>{
+    public:
+        explicit FHashLruCache(size_t capacity, size_t sliceNum = 0, bool bufferedPromotion = false,
+                               FWeigher<Key, Value> weigher = nullptr)
+        : capacity_(capacity)
+        , sliceNum_(sliceNum > 0 ? sliceNum : defaultSliceNum(capacity)){
+            size_t sliceSize = (capacity_ + sliceNum_ - 1) / sliceNum_;
+            for(size_t i = 0; i < sliceNum_; ++i)
+                lruSliceCaches_.emplace_back(new FLruCache<Key, Value>(sliceSize, bufferedPromotion, weigher));
+        }
+
+        // 各分片依次加锁求和，并发写入时只是近似值
+        size_t weightedSize(){
+            size_t size = 0;
+            for(auto& slice : lruSliceCaches_)
+                size += slice->weightedSize();
+            return size;
+        }
+
+        ~FHashLruCache() override = default;
+
+        void put(const Key& key, const Value& value) override{
+            getSlice(key).put(key, value);
+        }
+
+        void put(Key key, Value&& value) override{
+            FLruCache<Key, Value>& slice = getSlice(key);
+            slice.put(std::move(key), std::move(value));
+        }
+
+        void put(const Key& key, const Value& value, std::chrono::nanoseconds ttl){
+            getSlice(key).put(key, value, ttl);
+        }
+
+        void put(Key key, Value&& value, std::chrono::nanoseconds ttl){
+            FLruCache<Key, Value>& slice = getSlice(key);
+            slice.put(std::move(key), std::move(value), ttl);
+        }
+
+        void tick(){
+            for(auto& slice : lruSliceCaches_)
+                slice->tick();
+        }
+
+        FCacheStats stats() override{
+            FCacheStats stats;
+            for(auto& slice : lruSliceCaches_)
+                stats += slice->stats();
+            return stats;
+        }
+
+        FLatencyHistogram latency(FCacheOp op) override{
+            FLatencyHistogram histogram;
+            for(auto& slice : lruSliceCaches_)
+                slice->latency_.mergeInto(op, histogram);
+            return histogram;
+        }
+
+        template<typename... Args>
+        void emplace(const Key& key, Args&&... args){
+            getSlice(key).emplace(key, std::forward<Args>(args)...);
+        }
+
+        bool get(const Key& key, Value& value) override{
+            return getSlice(key).get(key, value);
+        }
+
+        Value get(const Key& key) override{
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        template<typename K, typename = FEnableTransparent<Key, K>>
+        bool get(const K& key, Value& value){
+            return getSlice(key).get(key, value);
+        }
+
+        template<typename K, typename = FEnableTransparent<Key, K>>
+        Value get(const K& key){
+            return getSlice(key).get(key);
+        }
+
+        FValueHandle<Value> getHandle(const Key& key) override{
+            return getSlice(key).getHandle(key);
+        }
+
+        // 各分片分别计一次批量延迟
+        size_t getMany(FSpan<const Key> keys, FSpan<Value> values, FSpan<bool> hits) override{
+            keys = this->batchKeys(keys, values, hits);
+            FSliceBatch batch(keys, sliceNum_, [this](const Key& key){ return sliceIndex(key); });
+            size_t hitCount = 0;
+            for(size_t s = 0; s < sliceNum_; ++s){
+                FSpan<const size_t> indices = batch.indices(s);
+                if(!indices.empty())
+                    hitCount += lruSliceCaches_[s]->getManyIndexed(keys, values, hits, indices);
+            }
+            return hitCount;
+        }
+
+        void putMany(FSpan<const Key> keys, FSpan<const Value> values) override{
+            keys = keys.first(values.size());
+            FSliceBatch batch(keys, sliceNum_, [this](const Key& key){ return sliceIndex(key); });
+            for(size_t s = 0; s < sliceNum_; ++s){
+                FSpan<const size_t> indices = batch.indices(s);
+                if(!indices.empty())
+                    lruSliceCaches_[s]->putManyIndexed(keys, values, indices);
+            }
+        }
+
+    private:
+        static size_t defaultSliceNum(size_t capacity){
+            size_t sliceNum = std::thread::hardware_concurrency();
+            if(sliceNum == 0) sliceNum = 1;
+            if(capacity > 0 && sliceNum > capacity) sliceNum = capacity; // 每个分片至少容纳一个条目
+            return sliceNum;
+        }
+
+        template<typename K>
+        size_t sliceIndex(const K& key) const{
+            return FHash<Key>{}(key) % sliceNum_;
+        }
+
+        template<typename K>
+        FLruCache<Key, Value>& getSlice(const K& key){
+            return *lruSliceCaches_[sliceIndex(key)];
+        }
+
+        size_t capacity_;
+        size_t sliceNum_;
+        std::vector<std::unique_ptr<FLruCache<Key, Value>>> lruSliceCaches_;
     };
 
 } // FulinCache
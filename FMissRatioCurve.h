@@ -0,0 +1,206 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+
+#ifndef FULINCACHE_FMISSRATIOCURVE_H
+#define FULINCACHE_FMISSRATIOCURVE_H
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "FHash.h"
+
+namespace FulinCache {
+    struct FMrcPoint {
+        size_t capacity;
+        double missRatio;
+    };
+
+    // 一遍扫描求LRU在所有容量下的未命中率曲线（Mattson栈距离）。
+    // 栈距离为上次访问该key以来访问过的不同key数（含自身），LRU容量c命中当且仅当距离<=c。
+    // 每个key只在树状数组中保留最近一次访问的时间戳，距离即两次访问之间仍存活的时间戳个数，每次访问O(log n)。
+    // 对过大的trace可按SHARDS做空间采样：只跟踪哈希落在阈值以下的key，距离按采样率放大。
+    //   samplingRate<1时为固定采样率，并按SHARDS_adj用期望采样数修正最小距离桶；
+    //   maxKeys>0时为固定内存：跟踪的key超过maxKeys就丢弃哈希最大的key并降低阈值，已有计数按新旧采样率之比缩放。
+    // bucketWidth把距离按宽度分桶，以牺牲容量分辨率换取直方图的内存
+    template<typename Key>
+    class FMissRatioCurve {
+    public:
+        explicit FMissRatioCurve(double samplingRate = 1.0, size_t maxKeys = 0, size_t bucketWidth = 1)
+        : threshold_(static_cast<uint64_t>(std::min(std::max(samplingRate, 0.0), 1.0) * static_cast<double>(kModulus)))
+        , maxKeys_(maxKeys)
+        , bucketWidth_(std::max<size_t>(bucketWidth, 1))
+        , clock_(0)
+        , accesses_(0)
+        , sampled_(0)
+        , scale_(1.0)
+        , tree_(kInitialSlots + 1, 0){
+            threshold_ = std::max<uint64_t>(threshold_, 1);
+        }
+
+        void access(const Key& key){
+            accesses_++;
+            uint64_t hash = mix(FHash<Key>()(key)) % kModulus;
+            if(hash >= threshold_)
+                return;
+            sampled_ += 1.0 / scale_;
+            if(clock_ == slots()) compact();
+
+            auto it = lastAccess_.find(key);
+            if(it != lastAccess_.end()){
+                uint64_t previous = it->second;
+                // previous之后仍存活的时间戳数即期间访问过的其他不同key
+                uint64_t distance = static_cast<uint64_t>(prefixSum(clock_) - prefixSum(previous + 1)) + 1;
+                add(previous, -1);
+                record(static_cast<double>(distance) / samplingRate());
+                it->second = clock_;
+            }else{
+                lastAccess_.emplace(key, clock_);
+                if(maxKeys_ > 0) tracked_.push({hash, key});
+            }
+            add(clock_, 1);
+            clock_++;
+
+            if(maxKeys_ > 0 && lastAccess_.size() > maxKeys_)
+                lowerThreshold();
+        }
+
+        uint64_t accesses() const {return accesses_;}
+
+        double samplingRate() const{
+            return static_cast<double>(threshold_) / static_cast<double>(kModulus);
+        }
+
+        // 容量为capacity个条目的LRU的未命中率，首次访问计为未命中
+        double missRatio(size_t capacity) const{
+            double adjustment = this->adjustment();
+            double total = sampled_ * scale_ + adjustment;
+            if(total <= 0) return 0.0;
+            size_t buckets = std::min(capacity / bucketWidth_, histogram_.size());
+            double hits = 0;
+            for(size_t i = 0; i < buckets; ++i)
+                hits += histogram_[i];
+            hits = hits * scale_ + adjustment;
+            return std::min(std::max(1.0 - hits / total, 0.0), 1.0);
+        }
+
+        // 每个距离桶的右端点一个点，直到未命中率不再下降
+        std::vector<FMrcPoint> curve() const{
+            std::vector<FMrcPoint> points;
+            double adjustment = this->adjustment();
+            double total = sampled_ * scale_ + adjustment;
+            if(total <= 0) return points;
+            double hits = 0;
+            for(size_t i = 0; i < histogram_.size(); ++i){
+                hits += histogram_[i];
+                double missRatio = 1.0 - (hits * scale_ + adjustment) / total;
+                points.push_back({(i + 1) * bucketWidth_, std::min(std::max(missRatio, 0.0), 1.0)});
+            }
+            return points;
+        }
+
+    private:
+        static constexpr uint64_t kModulus = uint64_t(1) << 24;
+        static constexpr size_t kInitialSlots = 1024;
+
+        // 只比较哈希，不要求Key可比较
+        struct HashLess {
+            bool operator()(const std::pair<uint64_t, Key>& a, const std::pair<uint64_t, Key>& b) const{
+                return a.first < b.first;
+            }
+        };
+
+        // std::hash对整数是恒等映射，采样前再混合一次，避免连续key只落在阈值一侧
+        static uint64_t mix(uint64_t x){
+            x += 0x9e3779b97f4a7c15ull;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+            return x ^ (x >> 31);
+        }
+
+        // 实际采到的访问数与按采样率的期望值之差补到最小距离桶（SHARDS_adj），
+        // 修正少数极热key是否恰好被采到带来的偏差。固定内存模式下计数已缩放到最终采样率，同样适用
+        double adjustment() const{
+            if(threshold_ >= kModulus) return 0.0;
+            return static_cast<double>(accesses_) * samplingRate() - sampled_ * scale_;
+        }
+
+        void record(double distance){
+            size_t bucket = static_cast<size_t>((distance - 1.0) / static_cast<double>(bucketWidth_));
+            if(bucket >= histogram_.size())
+                histogram_.resize(bucket + 1, 0.0);
+            histogram_[bucket] += 1.0 / scale_;
+        }
+
+        // 丢弃哈希最大的key，阈值降到它的哈希值，已有的计数按新旧采样率之比缩放。
+        // 缩放只乘到scale_上，之后的计数按1/scale_累加，不必每次遍历直方图
+        void lowerThreshold(){
+            double oldRate = samplingRate();
+            while(lastAccess_.size() > maxKeys_ && !tracked_.empty()){
+                uint64_t hash = tracked_.top().first;
+                threshold_ = hash;
+                while(!tracked_.empty() && tracked_.top().first >= threshold_){
+                    auto it = lastAccess_.find(tracked_.top().second);
+                    add(it->second, -1);
+                    lastAccess_.erase(it);
+                    tracked_.pop();
+                }
+            }
+            scale_ *= samplingRate() / oldRate;
+        }
+
+        // 时间戳用完时把存活的时间戳按先后重新编号为0..n-1，树的大小取存活数的两倍，摊还O(1)
+        void compact(){
+            std::vector<uint64_t*> live;
+            live.reserve(lastAccess_.size());
+            for(auto& entry : lastAccess_)
+                live.push_back(&entry.second);
+            std::sort(live.begin(), live.end(), [](const uint64_t* a, const uint64_t* b){ return *a < *b; });
+            for(size_t i = 0; i < live.size(); ++i)
+                *live[i] = i;
+            size_t slots = std::max(live.size() * 2, kInitialSlots);
+            tree_.assign(slots + 1, 0);
+            // 前live.size()个位置为1，线性时间建树
+            for(size_t i = 1; i <= slots; ++i){
+                tree_[i] += i <= live.size() ? 1 : 0;
+                size_t parent = i + (i & (~i + 1));
+                if(parent <= slots) tree_[parent] += tree_[i];
+            }
+            clock_ = live.size();
+        }
+
+        size_t slots() const {return tree_.size() - 1;}
+
+        void add(uint64_t position, int64_t delta){
+            for(size_t i = static_cast<size_t>(position) + 1; i < tree_.size(); i += i & (~i + 1))
+                tree_[i] += delta;
+        }
+
+        // 位置[0, end)之和
+        int64_t prefixSum(uint64_t end) const{
+            int64_t sum = 0;
+            for(size_t i = static_cast<size_t>(end); i > 0; i -= i & (~i + 1))
+                sum += tree_[i];
+            return sum;
+        }
+
+        uint64_t threshold_;
+        size_t maxKeys_;
+        size_t bucketWidth_;
+        uint64_t clock_;
+        uint64_t accesses_;
+        double sampled_;      // 采样到的访问数，与histogram_一样乘以scale_才是实际值
+        double scale_;        // 固定内存模式下历次降低采样率的累积缩放
+        std::vector<int64_t> tree_;   // 树状数组，下标从1开始
+        std::vector<double> histogram_; // histogram_[i]为距离落在(i*w, (i+1)*w]的访问数
+        std::unordered_map<Key, uint64_t, FHash<Key>> lastAccess_; // key -> 最近一次访问的时间戳
+        std::priority_queue<std::pair<uint64_t, Key>, std::vector<std::pair<uint64_t, Key>>, HashLess> tracked_; // 固定内存模式下按哈希取最大的key
+    };
+
+} // FulinCache
+
+#endif //FULINCACHE_FMISSRATIOCURVE_H
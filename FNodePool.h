@@ -0,0 +1,74 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+
+#ifndef FULINCACHE_FNODEPOOL_H
+#define FULINCACHE_FNODEPOOL_H
+#include <memory>
+#include <vector>
+#include <new>
+#include <utility>
+
+namespace FulinCache {
+    // 节点内存池：按slab批量申请内存，释放的节点挂到空闲链表上复用，不再归还给分配器。
+    // 池本身不加锁，由所属缓存的锁保护；池析构时只释放内存，存活节点需由缓存先行deallocate。
+    template<typename Node>
+    class FNodePool {
+    public:
+        explicit FNodePool(size_t initialSlabSize = 16)
+        : freeList_(nullptr)
+        , nextSlabSize_(initialSlabSize > 0 ? initialSlabSize : 1)
+        , currentSlabSize_(0)
+        , nextInSlab_(0){}
+
+        FNodePool(const FNodePool&) = delete;
+        FNodePool& operator=(const FNodePool&) = delete;
+
+        template<typename... Args>
+        Node* allocate(Args&&... args){
+            Slot* slot = acquireSlot();
+            return new (slot->storage) Node(std::forward<Args>(args)...);
+        }
+
+        void deallocate(Node* node){
+            if(!node) return;
+            node->~Node();
+            Slot* slot = reinterpret_cast<Slot*>(node);
+            slot->nextFree = freeList_;
+            freeList_ = slot;
+        }
+
+    private:
+        union Slot {
+            Slot* nextFree;
+            alignas(Node) unsigned char storage[sizeof(Node)];
+        };
+
+        static constexpr size_t kMaxSlabSize = 4096;
+
+        Slot* acquireSlot(){
+            if(freeList_){
+                Slot* slot = freeList_;
+                freeList_ = slot->nextFree;
+                return slot;
+            }
+            if(nextInSlab_ == currentSlabSize_){
+                currentSlabSize_ = nextSlabSize_;
+                slabs_.emplace_back(new Slot[currentSlabSize_]);
+                nextInSlab_ = 0;
+                if(nextSlabSize_ < kMaxSlabSize)
+                    nextSlabSize_ *= 2;
+            }
+            return &slabs_.back()[nextInSlab_++];
+        }
+
+        std::vector<std::unique_ptr<Slot[]>> slabs_;
+        Slot* freeList_;
+        size_t nextSlabSize_;
+        size_t currentSlabSize_;
+        size_t nextInSlab_;
+    };
+
+} // FulinCache
+
+#endif //FULINCACHE_FNODEPOOL_H
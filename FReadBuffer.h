@@ -0,0 +1,69 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+
+#ifndef FULINCACHE_FREADBUFFER_H
+#define FULINCACHE_FREADBUFFER_H
+#include <atomic>
+#include <algorithm>
+#include "FThreadStripe.h"
+
+namespace FulinCache {
+    // 有损的分段读缓冲：读线程在共享锁下把命中的节点记录到按线程分散的分段里，
+    // 分段写满后后续记录直接丢弃；持有独占锁的线程批量drain，回放这些访问。
+    // record只能在持有共享锁（或独占锁）时调用，drain只能在持有独占锁时调用，
+    // 因此两者之间的可见性由锁保证，分段内部只需relaxed原子操作。
+    template<typename T, size_t StripeCount = 16, size_t StripeSize = 32>
+    class FReadBuffer {
+        static_assert((StripeCount & (StripeCount - 1)) == 0, "StripeCount must be a power of two");
+    public:
+        FReadBuffer(){
+            for(Stripe& stripe : stripes_){
+                stripe.writeCount.store(0, std::memory_order_relaxed);
+                for(auto& item : stripe.items)
+                    item.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        FReadBuffer(const FReadBuffer&) = delete;
+        FReadBuffer& operator=(const FReadBuffer&) = delete;
+
+        // 返回true表示所在分段已满，调用方应尝试获取独占锁并drain
+        bool record(T* item){
+            Stripe& stripe = stripes_[stripeIndex()];
+            size_t index = stripe.writeCount.fetch_add(1, std::memory_order_relaxed);
+            if(index >= StripeSize)
+                return true;
+            stripe.items[index].store(item, std::memory_order_relaxed);
+            return index + 1 == StripeSize;
+        }
+
+        template<typename Func>
+        void drain(Func&& func){
+            for(Stripe& stripe : stripes_){
+                size_t count = std::min(stripe.writeCount.load(std::memory_order_relaxed), StripeSize);
+                for(size_t i = 0; i < count; ++i){
+                    T* item = stripe.items[i].exchange(nullptr, std::memory_order_relaxed);
+                    if(item) func(item);
+                }
+                stripe.writeCount.store(0, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        struct alignas(64) Stripe {
+            std::atomic<size_t> writeCount;
+            std::atomic<T*> items[StripeSize];
+        };
+
+        // 与统计计数同样按线程到达顺序轮转分配，前StripeCount个线程各占一个分段
+        static size_t stripeIndex(){
+            return threadOrdinal() & (StripeCount - 1);
+        }
+
+        Stripe stripes_[StripeCount];
+    };
+
+} // FulinCache
+
+#endif //FULINCACHE_FREADBUFFER_H
@@ -0,0 +1,43 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+
+#ifndef FULINCACHE_FSLICEBATCH_H
+#define FULINCACHE_FSLICEBATCH_H
+#include <vector>
+
+#include "FSpan.h"
+
+namespace FulinCache {
+    // 把一批key按所属分片做计数排序，使分片缓存的批量接口对每个分片只加一次锁
+    class FSliceBatch {
+    public:
+        template<typename Key, typename SliceOf>
+        FSliceBatch(FSpan<const Key> keys, size_t sliceNum, SliceOf&& sliceOf)
+        : offsets_(sliceNum + 1, 0)
+        , order_(keys.size()){
+            std::vector<size_t> slices(keys.size());
+            for(size_t i = 0; i < keys.size(); ++i){
+                slices[i] = sliceOf(keys[i]);
+                offsets_[slices[i] + 1]++;
+            }
+            for(size_t s = 0; s < sliceNum; ++s)
+                offsets_[s + 1] += offsets_[s];
+            std::vector<size_t> cursor(offsets_.begin(), offsets_.end() - 1);
+            for(size_t i = 0; i < keys.size(); ++i)
+                order_[cursor[slices[i]]++] = i;
+        }
+
+        // 第slice个分片负责的key在原批次中的下标
+        FSpan<const size_t> indices(size_t slice) const{
+            return FSpan<const size_t>(order_.data() + offsets_[slice], offsets_[slice + 1] - offsets_[slice]);
+        }
+
+    private:
+        std::vector<size_t> offsets_;
+        std::vector<size_t> order_;
+    };
+
+} // FulinCache
+
+#endif //FULINCACHE_FSLICEBATCH_H
@@ -0,0 +1,41 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+
+#ifndef FULINCACHE_FSPAN_H
+#define FULINCACHE_FSPAN_H
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace FulinCache {
+    // C++17下std::span的最小替代：一段连续元素的非拥有视图，可由vector/array/指针+长度构造
+    template<typename T>
+    class FSpan {
+    public:
+        FSpan(): data_(nullptr), size_(0){}
+        FSpan(T* data, size_t size): data_(data), size_(size){}
+
+        template<typename Container, typename = std::enable_if_t<
+                !std::is_same<std::decay_t<Container>, FSpan>::value &&
+                std::is_convertible<decltype(std::declval<Container&>().data()), T*>::value>>
+        FSpan(Container& container): data_(container.data()), size_(container.size()){}
+
+        T* data() const {return data_;}
+        size_t size() const {return size_;}
+        bool empty() const {return size_ == 0;}
+        T& operator[](size_t index) const {return data_[index];}
+        T* begin() const {return data_;}
+        T* end() const {return data_ + size_;}
+
+        // 前count个元素，count超过长度时取全部
+        FSpan first(size_t count) const {return FSpan(data_, count < size_ ? count : size_);}
+
+    private:
+        T* data_;
+        size_t size_;
+    };
+
+} // FulinCache
+
+#endif //FULINCACHE_FSPAN_H
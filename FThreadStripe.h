@@ -0,0 +1,28 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+
+#ifndef FULINCACHE_FTHREADSTRIPE_H
+#define FULINCACHE_FTHREADSTRIPE_H
+#include <atomic>
+#include <cstddef>
+
+namespace FulinCache {
+    constexpr size_t kCounterStripes = 16;
+
+    // 线程首次调用时按到达顺序分配序号，之后固定不变。所有按线程分条带的结构都由它取条带号，
+    // 同一线程的计数、计时和读缓冲记录落在同号条带上
+    inline size_t threadOrdinal(){
+        static std::atomic<size_t> nextThread(0);
+        thread_local size_t ordinal = nextThread.fetch_add(1, std::memory_order_relaxed);
+        return ordinal;
+    }
+
+    // FStatsCounter与FLatencyRecorder的条带号
+    inline size_t counterStripeIndex(){
+        return threadOrdinal() % kCounterStripes;
+    }
+
+} // FulinCache
+
+#endif //FULINCACHE_FTHREADSTRIPE_H
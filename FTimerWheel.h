@@ -0,0 +1,133 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+
+#ifndef FULINCACHE_FTIMERWHEEL_H
+#define FULINCACHE_FTIMERWHEEL_H
+#include <cstdint>
+#include <chrono>
+#include <algorithm>
+
+namespace FulinCache {
+    // 分层时间轮，管理带过期时间的缓存节点。节点需提供expireAt（纳秒时间戳，0表示不过期）
+    // 以及timerPrev/timerNext两个指针，并把FTimerWheel<Node>声明为友元；时间轮不负责节点的生命周期。
+    // 各层桶宽依次约为1毫秒、67毫秒、4.3秒、4.6分钟、4.9小时，最后一层放13天以后才过期的节点。
+    // advance时只处理时钟走过的那些桶：已过期的交给回调，未过期的重新放入更低层，
+    // 每个节点在到期前最多被搬动层数次，回收的均摊代价为O(1)。
+    template<typename Node>
+    class FTimerWheel {
+    public:
+        explicit FTimerWheel(uint64_t now): nanos_(now){
+            for(size_t level = 0; level < kLevels; ++level){
+                for(size_t i = 0; i < kBuckets[level]; ++i){
+                    Node* sentinel = bucket(level, i);
+                    sentinel->timerPrev = sentinel;
+                    sentinel->timerNext = sentinel;
+                }
+            }
+        }
+
+        FTimerWheel(const FTimerWheel&) = delete;
+        FTimerWheel& operator=(const FTimerWheel&) = delete;
+
+        static uint64_t now(){
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        // 从现在起ttl后的过期时间，ttl不为正时立即过期，过大时饱和
+        static uint64_t deadline(std::chrono::nanoseconds ttl){
+            uint64_t current = now();
+            uint64_t duration = static_cast<uint64_t>(std::max<std::chrono::nanoseconds::rep>(ttl.count(), 1));
+            return duration > UINT64_MAX - current ? UINT64_MAX : current + duration;
+        }
+
+        // 按node->expireAt放入对应的桶，已在轮中时先移出
+        void schedule(Node* node){
+            if(node->timerNext)
+                deschedule(node);
+            Node* sentinel = findBucket(node->expireAt);
+            node->timerNext = sentinel;
+            node->timerPrev = sentinel->timerPrev;
+            sentinel->timerPrev->timerNext = node;
+            sentinel->timerPrev = node;
+        }
+
+        void deschedule(Node* node){
+            if(!node->timerNext) return;
+            node->timerPrev->timerNext = node->timerNext;
+            node->timerNext->timerPrev = node->timerPrev;
+            node->timerPrev = nullptr;
+            node->timerNext = nullptr;
+        }
+
+        // 把时间推进到now，对每个已过期的节点调用expire(node)，调用时节点已移出时间轮
+        template<typename Expire>
+        void advance(uint64_t now, Expire&& expire){
+            uint64_t previous = nanos_;
+            if(now <= previous) return;
+            nanos_ = now;
+            for(size_t level = 0; level < kLevels; ++level){
+                uint64_t previousTicks = previous >> kShift[level];
+                uint64_t currentTicks = now >> kShift[level];
+                if(currentTicks == previousTicks) break;
+                expireLevel(level, previousTicks, currentTicks - previousTicks, expire);
+            }
+        }
+
+    private:
+        static constexpr size_t kLevels = 6;
+        static constexpr size_t kBuckets[kLevels] = {64, 64, 64, 64, 64, 1};
+        // 第i层桶宽为2^kShift[i]纳秒，且kBuckets[i]个桶恰好覆盖第i+1层的一个桶
+        static constexpr unsigned kShift[kLevels] = {20, 26, 32, 38, 44, 50};
+        static constexpr size_t kTotalBuckets = 64 * 5 + 1;
+
+        Node* bucket(size_t level, size_t index){
+            size_t offset = 0;
+            for(size_t i = 0; i < level; ++i)
+                offset += kBuckets[i];
+            return &sentinels_[offset + index];
+        }
+
+        Node* findBucket(uint64_t expireAt){
+            // 已过期的节点放进当前桶，时钟走过下一格时即被回收
+            uint64_t time = std::max(expireAt, nanos_);
+            uint64_t duration = time - nanos_;
+            for(size_t level = 0; level + 1 < kLevels; ++level){
+                if(duration < (uint64_t(1) << kShift[level + 1]))
+                    return bucket(level, (time >> kShift[level]) & (kBuckets[level] - 1));
+            }
+            return bucket(kLevels - 1, 0);
+        }
+
+        template<typename Expire>
+        void expireLevel(size_t level, uint64_t previousTicks, uint64_t delta, Expire& expire){
+            size_t mask = kBuckets[level] - 1;
+            size_t steps = static_cast<size_t>(std::min<uint64_t>(delta + 1, kBuckets[level]));
+            size_t start = static_cast<size_t>(previousTicks & mask);
+            for(size_t i = start; i < start + steps; ++i){
+                Node* sentinel = bucket(level, i & mask);
+                Node* node = sentinel->timerNext;
+                // 先把整个桶摘下来，回调里删除节点或重新调度都不会影响遍历
+                sentinel->timerPrev = sentinel;
+                sentinel->timerNext = sentinel;
+                while(node != sentinel){
+                    Node* next = node->timerNext;
+                    node->timerPrev = nullptr;
+                    node->timerNext = nullptr;
+                    if(node->expireAt <= nanos_)
+                        expire(node);
+                    else
+                        schedule(node);
+                    node = next;
+                }
+            }
+        }
+
+        uint64_t nanos_; // 时间轮当前时间
+        Node sentinels_[kTotalBuckets];
+    };
+
+} // FulinCache
+
+#endif //FULINCACHE_FTIMERWHEEL_H
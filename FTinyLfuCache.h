@@ -0,0 +1,322 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+
+#ifndef FULINCACHE_FTINYLFUCACHE_H
+#define FULINCACHE_FTINYLFUCACHE_H
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "FICachePolicy.h"
+#include "FNodePool.h"
+#include "FFlatMap.h"
+
+namespace FulinCache {
+    // 4行Count-Min频率草图，每个计数器4位、每个uint64_t存16个。
+    // 累计记录次数达到采样上限后所有计数器减半，使频率估计随时间衰减。
+    class FCountMinSketch {
+    public:
+        explicit FCountMinSketch(size_t capacity)
+        : additions_(0){
+            size_t counters = 16;
+            while(counters < capacity) counters <<= 1;
+            tableMask_ = counters / 16 - 1;
+            table_.assign(counters / 16 * kDepth, 0);
+            sampleSize_ = capacity > 0 ? capacity * 10 : 10;
+        }
+
+        void increment(size_t hash){
+            bool added = false;
+            for(size_t row = 0; row < kDepth; ++row){
+                size_t index = wordIndex(hash, row);
+                size_t shift = counterShift(hash, row);
+                uint64_t counter = (table_[index] >> shift) & 0xF;
+                if(counter < 15){
+                    table_[index] += uint64_t(1) << shift;
+                    added = true;
+                }
+            }
+            if(added && ++additions_ >= sampleSize_)
+                reset();
+        }
+
+        size_t frequency(size_t hash) const{
+            size_t frequency = 15;
+            for(size_t row = 0; row < kDepth; ++row){
+                uint64_t counter = (table_[wordIndex(hash, row)] >> counterShift(hash, row)) & 0xF;
+                if(counter < frequency) frequency = counter;
+            }
+            return frequency;
+        }
+
+    private:
+        static constexpr size_t kDepth = 4;
+
+        static uint64_t rehash(size_t hash, size_t row){
+            static const uint64_t seeds[kDepth] = {
+                0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL,
+                0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL
+            };
+            uint64_t x = (uint64_t(hash) + seeds[row]) * 0x9e3779b97f4a7c15ULL;
+            return x ^ (x >> 32);
+        }
+
+        size_t wordIndex(size_t hash, size_t row) const{
+            return row * (tableMask_ + 1) + (rehash(hash, row) & tableMask_);
+        }
+
+        static size_t counterShift(size_t hash, size_t row){
+            return ((rehash(hash, row) >> 40) & 0xF) * 4;
+        }
+
+        void reset(){
+            for(uint64_t& word : table_)
+                word = (word >> 1) & 0x7777777777777777ULL;
+            additions_ /= 2;
+        }
+
+        std::vector<uint64_t> table_;
+        size_t tableMask_;
+        size_t sampleSize_;
+        size_t additions_;
+    };
+
+    template<typename Key, typename Value> class FTinyLfuCache;
+
+    template<typename Key, typename Value>
+    class TinyLfuNode{
+    public:
+        enum class Segment : unsigned char { Window, Probation, Protected };
+
+        TinyLfuNode(): key_(), value_(), segment(Segment::Window), next(nullptr), prev(nullptr){}
+        template<typename K, typename... Args>
+        explicit TinyLfuNode(K&& key, Args&&... args)
+        : key_(std::forward<K>(key)), value_(std::forward<Args>(args)...), segment(Segment::Window), next(nullptr), prev(nullptr){}
+
+        const Key& getKey() const {return key_;}
+        const Value& getValue() const {return value_;}
+        template<typename... Args>
+        void setValue(Args&&... args) {value_ = Value(std::forward<Args>(args)...);}
+
+        friend class FTinyLfuCache<Key, Value>;
+    private:
+        Key key_;
+        Value value_;
+        Segment segment;
+        TinyLfuNode* next;
+        TinyLfuNode* prev;
+    };
+
+    // W-TinyLFU：新条目先进入约占1%容量的窗口LRU；窗口淘汰出的候选者与主区（分段LRU：
+    // 试用段+占主区80%的保护段）试用段末尾的牺牲者比较草图中的频率，频率更高者才能留在主区。
+    template<typename Key, typename Value>
+    class FTinyLfuCache: public FICachePolicy<Key, Value> {
+    public:
+        using NodeType = TinyLfuNode<Key, Value>;
+        using NodePtr = NodeType*;
+        using NodeMap = FFlatMap<Key, NodeType>;
+        using Segment = typename NodeType::Segment;
+
+        explicit FTinyLfuCache(size_t capacity)
+        : capacity_(capacity)
+        , windowCapacity_(capacity > 100 ? capacity / 100 : 1)
+        , protectedCapacity_((capacity - std::min(capacity, windowCapacity_)) * 8 / 10)
+        , sketch_(capacity){}
+
+        ~FTinyLfuCache() override{
+            nodeMap_.forEach([this](NodePtr node){
+                pool_.deallocate(node);
+            });
+        }
+
+        bool get(const Key& key, Value& value) override{
+            return getImpl(key, value);
+        }
+
+        Value get(const Key& key) override{
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        template<typename K, typename = FEnableTransparent<Key, K>>
+        bool get(const K& key, Value& value){
+            return getImpl(key, value);
+        }
+
+        template<typename K, typename = FEnableTransparent<Key, K>>
+        Value get(const K& key){
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        void put(const Key& key, const Value& value) override{
+            putNode(key, value);
+        }
+
+        void put(Key key, Value&& value) override{
+            putNode(std::move(key), std::move(value));
+        }
+
+        // 用args在节点内直接构造value
+        template<typename... Args>
+        void emplace(const Key& key, Args&&... args){
+            putNode(key, std::forward<Args>(args)...);
+        }
+
+        FCacheStats stats() override{
+            std::lock_guard<std::mutex> lock(mutex_);
+            return stats_.snapshot(nodeMap_.size());
+        }
+
+        FLatencyHistogram latency(FCacheOp op) override{
+            FLatencyHistogram histogram;
+            latency_.mergeInto(op, histogram);
+            return histogram;
+        }
+
+    private:
+        template<typename K>
+        bool getImpl(const K& key, Value& value){
+            FLatencyTimer timer(latency_, FCacheOp::Get);
+            std::lock_guard<std::mutex> lock(mutex_);
+            sketch_.increment(FHash<Key>{}(key));
+            NodePtr node = nodeMap_.find(key);
+            if(!node){
+                stats_.record(FStatsCounter::Miss);
+                return false;
+            }
+            value = node->getValue();
+            onHit(node);
+            stats_.record(FStatsCounter::Hit);
+            return true;
+        }
+
+        template<typename K, typename... Args>
+        void putNode(K&& key, Args&&... args){
+            if(capacity_ == 0) return;
+            FLatencyTimer timer(latency_, FCacheOp::Put);
+            std::lock_guard<std::mutex> lock(mutex_);
+            sketch_.increment(FHash<Key>{}(key));
+            NodePtr node = nodeMap_.find(key);
+            if(node){
+                node->setValue(std::forward<Args>(args)...);
+                onHit(node);
+                stats_.record(FStatsCounter::Update);
+                return;
+            }
+            node = pool_.allocate(std::forward<K>(key), std::forward<Args>(args)...);
+            nodeMap_.insert(node);
+            segment(Segment::Window).pushFront(node);
+            stats_.record(FStatsCounter::Put);
+            if(segment(Segment::Window).size > windowCapacity_)
+                evictFromWindow();
+        }
+
+        struct SegmentList{
+            SegmentList(): size(0){
+                head.next = &tail;
+                tail.prev = &head;
+            }
+            SegmentList(const SegmentList&) = delete;
+            SegmentList& operator=(const SegmentList&) = delete;
+
+            void pushFront(NodePtr node){
+                node->next = head.next;
+                node->prev = &head;
+                head.next->prev = node;
+                head.next = node;
+                size++;
+            }
+
+            void remove(NodePtr node){
+                node->prev->next = node->next;
+                node->next->prev = node->prev;
+                node->next = nullptr;
+                node->prev = nullptr;
+                size--;
+            }
+
+            NodePtr last(){
+                return tail.prev != &head ? tail.prev : nullptr;
+            }
+
+            NodeType head;
+            NodeType tail;
+            size_t size;
+        };
+
+        SegmentList& segment(Segment tag){
+            return segments_[static_cast<size_t>(tag)];
+        }
+
+        void moveTo(NodePtr node, Segment tag){
+            segment(node->segment).remove(node);
+            node->segment = tag;
+            segment(tag).pushFront(node);
+        }
+
+        void onHit(NodePtr node){
+            if(node->segment != Segment::Probation){
+                moveTo(node, node->segment);
+                return;
+            }
+            moveTo(node, Segment::Protected);
+            if(segment(Segment::Protected).size > protectedCapacity_){
+                NodePtr demoted = segment(Segment::Protected).last();
+                if(demoted) moveTo(demoted, Segment::Probation);
+            }
+        }
+
+        void evictFromWindow(){
+            FLatencyTimer timer(latency_, FCacheOp::Evict);
+            NodePtr candidate = segment(Segment::Window).last();
+            if(!candidate) return;
+            size_t mainSize = segment(Segment::Probation).size + segment(Segment::Protected).size;
+            if(mainSize + windowCapacity_ < capacity_){
+                moveTo(candidate, Segment::Probation);
+                return;
+            }
+            NodePtr victim = segment(Segment::Probation).last();
+            if(!victim) victim = segment(Segment::Protected).last();
+            if(!victim){
+                removeEntry(candidate);
+                return;
+            }
+            size_t candidateFreq = sketch_.frequency(FHash<Key>{}(candidate->getKey()));
+            size_t victimFreq = sketch_.frequency(FHash<Key>{}(victim->getKey()));
+            if(candidateFreq > victimFreq){
+                removeEntry(victim);
+                moveTo(candidate, Segment::Probation);
+            }else{
+                removeEntry(candidate);
+            }
+        }
+
+        void removeEntry(NodePtr node){
+            stats_.record(FStatsCounter::Eviction);
+            segment(node->segment).remove(node);
+            nodeMap_.erase(node->getKey());
+            pool_.deallocate(node);
+        }
+
+        size_t capacity_;
+        size_t windowCapacity_;
+        size_t protectedCapacity_;
+
+        FCountMinSketch sketch_;
+        FNodePool<NodeType> pool_;
+        NodeMap nodeMap_;
+        SegmentList segments_[3];
+        FStatsCounter stats_;
+        FLatencyRecorder latency_;
+        std::mutex mutex_;
+    };
+
+} // FulinCache
+
+#endif //FULINCACHE_FTINYLFUCACHE_H
@@ -0,0 +1,71 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+
+#ifndef FULINCACHE_FVALUESLOT_H
+#define FULINCACHE_FVALUESLOT_H
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace FulinCache {
+    // 是否以引用计数块保存某类value。默认为false：value直接内联在节点里，put/更新不额外分配内存，
+    // getHandle时拷贝一份交给句柄。value较大且常用getHandle读取时可照此特化为true，
+    // 节点改为保存shared_ptr<const Value>，getHandle不再拷贝，代价是每次put/更新多一次堆分配
+    template<typename Value>
+    struct FSharedValue: std::false_type {};
+
+    // 缓存节点中的value存储，按FSharedValue<Value>选择内联或引用计数
+    template<typename Value, bool Shared = FSharedValue<Value>::value>
+    class FValueSlot {
+    public:
+        FValueSlot(): value_(){}
+
+        template<typename... Args>
+        explicit FValueSlot(std::in_place_t, Args&&... args): value_(std::forward<Args>(args)...){}
+
+        const Value& get() const {return value_;}
+
+        std::shared_ptr<const Value> handle() const {return std::make_shared<const Value>(value_);}
+
+        // 单个可直接赋值的参数（如value本身）原地赋值，省去一次临时对象
+        template<typename... Args>
+        void set(Args&&... args){
+            if constexpr(sizeof...(Args) == 1 && (std::is_assignable<Value&, Args&&>::value && ...))
+                value_ = (std::forward<Args>(args), ...);
+            else
+                value_ = Value(std::forward<Args>(args)...);
+        }
+
+        // 释放value占用的资源（ARC幽灵条目）
+        void reset() {value_ = Value();}
+
+    private:
+        Value value_;
+    };
+
+    template<typename Value>
+    class FValueSlot<Value, true> {
+    public:
+        FValueSlot(): value_(){}
+
+        template<typename... Args>
+        explicit FValueSlot(std::in_place_t, Args&&... args)
+        : value_(std::make_shared<const Value>(std::forward<Args>(args)...)){}
+
+        const Value& get() const {return *value_;}
+
+        std::shared_ptr<const Value> handle() const {return value_;}
+
+        template<typename... Args>
+        void set(Args&&... args) {value_ = std::make_shared<const Value>(std::forward<Args>(args)...);}
+
+        void reset() {value_.reset();}
+
+    private:
+        std::shared_ptr<const Value> value_;
+    };
+
+} // FulinCache
+
+#endif //FULINCACHE_FVALUESLOT_H
@@ -0,0 +1,79 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+// 比较大容量FLruCache上逐个get、整批加锁但不预取（getManyNoPrefetch）与getMany批量查找的每key耗时。
+// get与不预取批量之比为锁摊销的收益，不预取批量与getMany之比为预取重叠cache miss的收益。
+// 用法: FBatchLookupBench [条目数=4000000] [查找次数=4000000] [批大小=64]
+// 条目数应使缓存明显大于末级缓存，否则预取几乎没有收益。
+
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+#include <chrono>
+#include <string>
+#include <memory>
+#include "../FLruCache.h"
+
+using BenchClock = std::chrono::steady_clock;
+
+static double nsPerKey(BenchClock::time_point begin, BenchClock::time_point end, size_t keys){
+    return std::chrono::duration<double, std::nano>(end - begin).count() / keys;
+}
+
+int main(int argc, char* argv[]){
+    const size_t ENTRIES = argc > 1 ? std::stoul(argv[1]) : 4000000;
+    const size_t LOOKUPS = argc > 2 ? std::stoul(argv[2]) : 4000000;
+    const size_t BATCH = argc > 3 ? std::stoul(argv[3]) : 64;
+
+    FulinCache::FLruCache<uint64_t, uint64_t> cache(ENTRIES);
+    for(uint64_t key = 0; key < ENTRIES; ++key)
+        cache.put(key, key);
+
+    // 查找全部命中且随机分布，每次访问都落在不同的缓存行上
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<uint64_t> dist(0, ENTRIES - 1);
+    std::vector<uint64_t> keys(LOOKUPS);
+    for(uint64_t& key : keys)
+        key = dist(gen);
+
+    uint64_t checksum = 0;
+    uint64_t value = 0;
+    auto begin = BenchClock::now();
+    for(uint64_t key : keys){
+        cache.get(key, value);
+        checksum += value;
+    }
+    auto end = BenchClock::now();
+    double singleNs = nsPerKey(begin, end, LOOKUPS);
+
+    std::vector<uint64_t> values(BATCH);
+    std::unique_ptr<bool[]> hits(new bool[BATCH]);
+    auto runBatches = [&](bool prefetch){
+        auto batchBegin = BenchClock::now();
+        for(size_t offset = 0; offset < LOOKUPS; offset += BATCH){
+            size_t count = std::min(BATCH, LOOKUPS - offset);
+            FulinCache::FSpan<const uint64_t> batchKeys(keys.data() + offset, count);
+            FulinCache::FSpan<uint64_t> batchValues(values.data(), count);
+            FulinCache::FSpan<bool> batchHits(hits.get(), count);
+            if(prefetch) cache.getMany(batchKeys, batchValues, batchHits);
+            else cache.getManyNoPrefetch(batchKeys, batchValues, batchHits);
+            for(size_t i = 0; i < count; ++i)
+                checksum += values[i];
+        }
+        return nsPerKey(batchBegin, BenchClock::now(), LOOKUPS);
+    };
+    double lockedNs = runBatches(false);
+    double batchNs = runBatches(true);
+
+    std::cout << "条目数:" << ENTRIES << " 查找次数:" << LOOKUPS << " 批大小:" << BATCH << std::endl;
+    std::cout << std::fixed << std::setprecision(1)
+              << "get               : " << singleNs << " ns/key" << std::endl
+              << "getManyNoPrefetch : " << lockedNs << " ns/key" << std::endl
+              << "getMany           : " << batchNs << " ns/key" << std::endl
+              << std::setprecision(2)
+              << "锁摊销加速比      : " << singleNs / lockedNs << "x" << std::endl
+              << "预取加速比        : " << lockedNs / batchNs << "x" << std::endl;
+    std::cout << "(checksum " << checksum << ")" << std::endl;
+    return 0;
+}
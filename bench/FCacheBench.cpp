@@ -0,0 +1,416 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+// 多线程缓存基准：对每种策略、每种负载、1..N个线程分别运行，报告吞吐、命中率与单次操作延迟分位。
+// 负载为main.cpp中的三个场景（热点访问、循环扫描、负载剧变）以及Zipf与均匀分布的随机读写。
+// 用法: FCacheBench [--threads=N] [--ops=N] [--format=table|json|csv]
+//                   [--capacity=N] [--keys=N] [--zipf=theta] [--workloads=a,b] [--policies=a,b]
+// --threads为最大线程数（默认为硬件线程数），按1,2,4...递增；--ops覆盖各负载的总操作数；
+// --capacity/--keys/--zipf只作用于zipf与uniform两个负载。延迟按每8次操作采样1次，减少计时本身的开销。
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../FLruCache.h"
+#include "../FLfuCache.h"
+#include "../FArcCache/FArcCache.h"
+#include "../FClockCache.h"
+#include "../FTinyLfuCache.h"
+#include "../FLatencyHistogram.h"
+
+using BenchClock = std::chrono::steady_clock;
+using Cache = FulinCache::FICachePolicy<int, std::string>;
+
+struct Op {
+    int key;
+    bool isPut;
+};
+
+struct Options {
+    size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    size_t ops = 0; // 0表示使用各负载默认值
+    std::string format = "table";
+    size_t capacity = 1000;
+    size_t keys = 100000;
+    double zipfTheta = 0.99;
+    std::vector<std::string> workloads;
+    std::vector<std::string> policies;
+};
+
+struct Workload {
+    std::string name;
+    size_t capacity;
+    size_t keySpace;       // 可能出现的key总数，用作LRU-K的历史容量
+    size_t defaultOps;
+    std::vector<int> warmKeys;
+    // 生成一个线程的操作序列，不同线程用不同种子
+    std::function<std::vector<Op>(size_t count, uint64_t seed)> generate;
+};
+
+struct Policy {
+    std::string name;
+    std::function<std::unique_ptr<Cache>(const Workload&)> make;
+};
+
+struct Result {
+    std::string workload;
+    std::string policy;
+    size_t threads;
+    size_t ops;
+    double seconds;
+    double hitRatio;
+    FulinCache::FLatencySummary latency;
+};
+
+// Gray等人的Zipf生成算法（YCSB同款），只对0<theta<1成立（theta为1时alpha除零），由parse检查
+class ZipfGenerator {
+public:
+    ZipfGenerator(size_t n, double theta)
+    : n_(n)
+    , theta_(theta)
+    , zetan_(zeta(n, theta))
+    , alpha_(1.0 / (1.0 - theta)){
+        double zeta2 = zeta(2, theta);
+        eta_ = (1.0 - std::pow(2.0 / static_cast<double>(n), 1.0 - theta)) / (1.0 - zeta2 / zetan_);
+    }
+
+    template<typename Gen>
+    size_t operator()(Gen& gen){
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(gen);
+        double uz = u * zetan_;
+        if(uz < 1.0) return 0;
+        if(uz < 1.0 + std::pow(0.5, theta_)) return 1;
+        size_t rank = static_cast<size_t>(static_cast<double>(n_) * std::pow(eta_ * u - eta_ + 1.0, alpha_));
+        return std::min(rank, n_ - 1);
+    }
+
+private:
+    static double zeta(size_t n, double theta){
+        double sum = 0;
+        for(size_t i = 1; i <= n; ++i)
+            sum += 1.0 / std::pow(static_cast<double>(i), theta);
+        return sum;
+    }
+
+    size_t n_;
+    double theta_;
+    double zetan_;
+    double alpha_;
+    double eta_;
+};
+
+static std::vector<int> range(int count){
+    std::vector<int> keys(count);
+    for(int i = 0; i < count; ++i) keys[i] = i;
+    return keys;
+}
+
+// 场景1：70%访问20个热点key，其余访问5000个冷key，30%写
+static Workload hotWorkload(){
+    const int HOT_KEYS = 20;
+    const int COLD_KEYS = 5000;
+    return {"hot", 20, HOT_KEYS + COLD_KEYS, 500000, range(HOT_KEYS),
+            [=](size_t count, uint64_t seed){
+                std::mt19937 gen(static_cast<uint32_t>(seed));
+                std::vector<Op> ops(count);
+                for(Op& op : ops){
+                    op.isPut = gen() % 100 < 30;
+                    op.key = gen() % 100 < 70 ? static_cast<int>(gen() % HOT_KEYS)
+                                              : HOT_KEYS + static_cast<int>(gen() % COLD_KEYS);
+                }
+                return ops;
+            }};
+}
+
+// 场景2：60%顺序循环扫描500个key，30%在循环范围内随机，10%访问范围外，20%写
+static Workload loopWorkload(){
+    const int LOOP_SIZE = 500;
+    return {"loop", 50, LOOP_SIZE * 2, 200000, range(LOOP_SIZE / 5),
+            [=](size_t count, uint64_t seed){
+                std::mt19937 gen(static_cast<uint32_t>(seed));
+                std::vector<Op> ops(count);
+                int position = 0;
+                for(size_t i = 0; i < count; ++i){
+                    ops[i].isPut = gen() % 100 < 20;
+                    if(i % 100 < 60){
+                        ops[i].key = position;
+                        position = (position + 1) % LOOP_SIZE;
+                    }else if(i % 100 < 90){
+                        ops[i].key = static_cast<int>(gen() % LOOP_SIZE);
+                    }else{
+                        ops[i].key = LOOP_SIZE + static_cast<int>(gen() % LOOP_SIZE);
+                    }
+                }
+                return ops;
+            }};
+}
+
+// 场景3：五个阶段依次为热点、大范围随机、顺序扫描、局部性随机、混合访问
+static Workload shiftWorkload(){
+    return {"shift", 30, 400, 80000, range(30),
+            [](size_t count, uint64_t seed){
+                std::mt19937 gen(static_cast<uint32_t>(seed));
+                std::vector<Op> ops(count);
+                size_t phaseLength = std::max<size_t>(count / 5, 1);
+                static const int putProbability[5] = {15, 30, 10, 25, 20};
+                for(size_t i = 0; i < count; ++i){
+                    size_t phase = std::min<size_t>(i / phaseLength, 4);
+                    ops[i].isPut = static_cast<int>(gen() % 100) < putProbability[phase];
+                    int key;
+                    switch(phase){
+                        case 0: key = gen() % 5; break;
+                        case 1: key = gen() % 400; break;
+                        case 2: key = static_cast<int>((i - phaseLength * 2) % 100); break;
+                        case 3: key = static_cast<int>((i / 800) % 5) * 15 + static_cast<int>(gen() % 15); break;
+                        default:{
+                            int r = gen() % 100;
+                            if(r < 40) key = gen() % 5;
+                            else if(r < 70) key = 5 + gen() % 45;
+                            else key = 50 + gen() % 350;
+                        }
+                    }
+                    ops[i].key = key;
+                }
+                return ops;
+            }};
+}
+
+// 10%写
+static Workload zipfWorkload(const Options& options){
+    size_t keys = options.keys;
+    double theta = options.zipfTheta;
+    auto zipf = std::make_shared<ZipfGenerator>(keys, theta);
+    return {"zipf", options.capacity, keys, 1000000, {},
+            [zipf](size_t count, uint64_t seed){
+                std::mt19937_64 gen(seed);
+                ZipfGenerator generator = *zipf;
+                std::vector<Op> ops(count);
+                for(Op& op : ops){
+                    op.isPut = gen() % 100 < 10;
+                    op.key = static_cast<int>(generator(gen));
+                }
+                return ops;
+            }};
+}
+
+static Workload uniformWorkload(const Options& options){
+    size_t keys = options.keys;
+    return {"uniform", options.capacity, keys, 1000000, {},
+            [keys](size_t count, uint64_t seed){
+                std::mt19937_64 gen(seed);
+                std::vector<Op> ops(count);
+                for(Op& op : ops){
+                    op.isPut = gen() % 100 < 10;
+                    op.key = static_cast<int>(gen() % keys);
+                }
+                return ops;
+            }};
+}
+
+static std::vector<Policy> allPolicies(){
+    using namespace FulinCache;
+    return {
+        {"LRU", [](const Workload& w){ return std::unique_ptr<Cache>(new FLruCache<int, std::string>(w.capacity)); }},
+        {"LFU", [](const Workload& w){ return std::unique_ptr<Cache>(new FLfuCache<int, std::string>(w.capacity)); }},
+        {"ARC", [](const Workload& w){ return std::unique_ptr<Cache>(new ArcCache<int, std::string>(w.capacity)); }},
+        {"LRU-K", [](const Workload& w){
+            return std::unique_ptr<Cache>(new FLruKCache<int, std::string>(w.capacity, w.keySpace, 2)); }},
+        {"CLOCK", [](const Workload& w){ return std::unique_ptr<Cache>(new FClockCache<int, std::string>(w.capacity)); }},
+        {"W-TinyLFU", [](const Workload& w){ return std::unique_ptr<Cache>(new FTinyLfuCache<int, std::string>(w.capacity)); }},
+        {"HashLRU", [](const Workload& w){ return std::unique_ptr<Cache>(new FHashLruCache<int, std::string>(w.capacity)); }},
+        {"HashLFU", [](const Workload& w){ return std::unique_ptr<Cache>(new FHashLfuCache<int, std::string>(w.capacity)); }},
+    };
+}
+
+static Result run(const Workload& workload, const Policy& policy, size_t threads, size_t totalOps){
+    const size_t SAMPLE_MASK = 7;
+    std::unique_ptr<Cache> cache = policy.make(workload);
+    for(int key : workload.warmKeys)
+        cache->put(key, "init" + std::to_string(key));
+
+    size_t opsPerThread = std::max<size_t>(totalOps / threads, 1);
+    std::vector<std::vector<Op>> ops(threads);
+    for(size_t t = 0; t < threads; ++t)
+        ops[t] = workload.generate(opsPerThread, 42 + t);
+
+    std::vector<std::unique_ptr<FulinCache::FLatencyHistogram>> histograms;
+    std::vector<size_t> hits(threads, 0), gets(threads, 0);
+    for(size_t t = 0; t < threads; ++t)
+        histograms.emplace_back(new FulinCache::FLatencyHistogram());
+
+    std::atomic<size_t> ready(0);
+    std::atomic<bool> start(false);
+    std::vector<std::thread> workers;
+    for(size_t t = 0; t < threads; ++t){
+        workers.emplace_back([&, t]{
+            const std::string value(32, 'v');
+            std::string result;
+            size_t localHits = 0, localGets = 0;
+            FulinCache::FLatencyHistogram& histogram = *histograms[t];
+            ready.fetch_add(1);
+            while(!start.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            const std::vector<Op>& mine = ops[t];
+            for(size_t i = 0; i < mine.size(); ++i){
+                const Op& op = mine[i];
+                bool sampled = (i & SAMPLE_MASK) == 0;
+                BenchClock::time_point begin;
+                if(sampled) begin = BenchClock::now();
+                if(op.isPut){
+                    cache->put(op.key, value);
+                }else{
+                    localGets++;
+                    if(cache->get(op.key, result)) localHits++;
+                }
+                if(sampled)
+                    histogram.record(static_cast<uint64_t>(
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(BenchClock::now() - begin).count()));
+            }
+            hits[t] = localHits;
+            gets[t] = localGets;
+        });
+    }
+    while(ready.load() < threads)
+        std::this_thread::yield();
+    BenchClock::time_point begin = BenchClock::now();
+    start.store(true, std::memory_order_release);
+    for(std::thread& worker : workers)
+        worker.join();
+    double seconds = std::chrono::duration<double>(BenchClock::now() - begin).count();
+
+    FulinCache::FLatencyHistogram merged;
+    size_t hitCount = 0, getCount = 0;
+    for(size_t t = 0; t < threads; ++t){
+        merged.merge(*histograms[t]);
+        hitCount += hits[t];
+        getCount += gets[t];
+    }
+    return {workload.name, policy.name, threads, opsPerThread * threads, seconds,
+            getCount ? static_cast<double>(hitCount) / static_cast<double>(getCount) : 0.0, merged.summary()};
+}
+
+static std::vector<std::string> split(const std::string& list){
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while(std::getline(stream, item, ','))
+        if(!item.empty()) items.push_back(item);
+    return items;
+}
+
+static bool selected(const std::vector<std::string>& filter, const std::string& name){
+    return filter.empty() || std::find(filter.begin(), filter.end(), name) != filter.end();
+}
+
+static Options parse(int argc, char* argv[]){
+    Options options;
+    for(int i = 1; i < argc; ++i){
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string name = arg.substr(0, eq);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+        if(name == "--threads") options.maxThreads = std::max<size_t>(std::stoul(value), 1);
+        else if(name == "--ops") options.ops = std::stoul(value);
+        else if(name == "--format") options.format = value;
+        else if(name == "--capacity") options.capacity = std::stoul(value);
+        else if(name == "--keys") options.keys = std::max<size_t>(std::stoul(value), 2);
+        else if(name == "--zipf") options.zipfTheta = std::stod(value);
+        else if(name == "--workloads") options.workloads = split(value);
+        else if(name == "--policies") options.policies = split(value);
+        else{
+            std::cerr << "未知参数: " << arg << std::endl;
+            std::exit(1);
+        }
+    }
+    if(!(options.zipfTheta > 0 && options.zipfTheta < 1)){
+        std::cerr << "--zipf须在(0, 1)内" << std::endl;
+        std::exit(1);
+    }
+    if(options.format != "table" && options.format != "json" && options.format != "csv"){
+        std::cerr << "--format只支持table、json、csv" << std::endl;
+        std::exit(1);
+    }
+    return options;
+}
+
+static double opsPerSecond(const Result& r){
+    return r.seconds > 0 ? static_cast<double>(r.ops) / r.seconds : 0.0;
+}
+
+static void printRow(const Options& options, const Result& r, bool first){
+    const FulinCache::FLatencySummary& l = r.latency;
+    if(options.format == "csv"){
+        std::cout << r.workload << ',' << r.policy << ',' << r.threads << ',' << r.ops << ','
+                  << std::fixed << std::setprecision(6) << r.seconds << ','
+                  << std::setprecision(0) << opsPerSecond(r) << ','
+                  << std::setprecision(6) << r.hitRatio << ','
+                  << l.p50 << ',' << l.p99 << ',' << l.p999 << ',' << l.max << '\n';
+    }else if(options.format == "json"){
+        std::cout << (first ? "  " : ",\n  ")
+                  << "{\"workload\":\"" << r.workload << "\",\"policy\":\"" << r.policy
+                  << "\",\"threads\":" << r.threads << ",\"ops\":" << r.ops
+                  << std::fixed << std::setprecision(6) << ",\"seconds\":" << r.seconds
+                  << std::setprecision(0) << ",\"ops_per_sec\":" << opsPerSecond(r)
+                  << std::setprecision(6) << ",\"hit_ratio\":" << r.hitRatio
+                  << ",\"p50_ns\":" << l.p50 << ",\"p99_ns\":" << l.p99
+                  << ",\"p999_ns\":" << l.p999 << ",\"max_ns\":" << l.max << "}";
+    }else{
+        std::cout << std::left << std::setw(9) << r.workload << std::setw(11) << r.policy
+                  << std::right << std::setw(4) << r.threads
+                  << std::fixed << std::setprecision(0) << std::setw(14) << opsPerSecond(r)
+                  << std::setprecision(2) << std::setw(9) << r.hitRatio * 100 << '%'
+                  << std::setw(9) << l.p50 << std::setw(9) << l.p99
+                  << std::setw(10) << l.p999 << std::setw(11) << l.max << '\n';
+    }
+    std::cout.flush();
+}
+
+int main(int argc, char* argv[]){
+    Options options = parse(argc, argv);
+
+    std::vector<Workload> workloads;
+    for(Workload& workload : std::vector<Workload>{hotWorkload(), loopWorkload(), shiftWorkload()})
+        if(selected(options.workloads, workload.name)) workloads.push_back(std::move(workload));
+    if(selected(options.workloads, "zipf")) workloads.push_back(zipfWorkload(options));
+    if(selected(options.workloads, "uniform")) workloads.push_back(uniformWorkload(options));
+
+    std::vector<size_t> threadCounts;
+    for(size_t t = 1; t < options.maxThreads; t *= 2)
+        threadCounts.push_back(t);
+    threadCounts.push_back(options.maxThreads);
+
+    if(options.format == "csv")
+        std::cout << "workload,policy,threads,ops,seconds,ops_per_sec,hit_ratio,p50_ns,p99_ns,p999_ns,max_ns\n";
+    else if(options.format == "json")
+        std::cout << "[\n";
+    else
+        std::cout << std::left << std::setw(9) << "workload" << std::setw(11) << "policy"
+                  << std::right << std::setw(4) << "thr" << std::setw(14) << "ops/s"
+                  << std::setw(10) << "hit" << std::setw(9) << "p50ns" << std::setw(9) << "p99ns"
+                  << std::setw(10) << "p99.9ns" << std::setw(11) << "maxns" << '\n';
+
+    bool first = true;
+    for(const Workload& workload : workloads){
+        size_t totalOps = options.ops ? options.ops : workload.defaultOps;
+        for(size_t threads : threadCounts){
+            for(const Policy& policy : allPolicies()){
+                if(!selected(options.policies, policy.name)) continue;
+                printRow(options, run(workload, policy, threads, totalOps), first);
+                first = false;
+            }
+        }
+    }
+    if(options.format == "json")
+        std::cout << "\n]\n";
+    return 0;
+}
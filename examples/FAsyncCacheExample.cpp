@@ -0,0 +1,134 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+// FAsyncCache的用法示例，只在-DFULINCACHE_COROUTINES=ON时构建，保证协程接口随主干一起编译。
+// 多个协程同时对同一个key调用loadAsync，只有第一个执行loader，其余挂起等待；
+// loader在另一个线程上完成后，所有等待者拿到同一个结果。结果不符时返回非0。
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../FAsyncCache.h"
+#include "../FLruCache.h"
+
+using FulinCache::FTask;
+
+// 手动触发的事件：co_await时挂起，fire后在调用fire的线程上恢复所有等待者
+class Event {
+public:
+    bool await_ready(){
+        std::lock_guard<std::mutex> lock(mutex_);
+        return fired_;
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle){
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(fired_) return false;
+        waiters_.push_back(handle);
+        return true;
+    }
+
+    void await_resume(){}
+
+    void fire(){
+        std::vector<std::coroutine_handle<>> waiters;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            fired_ = true;
+            waiters.swap(waiters_);
+        }
+        for(std::coroutine_handle<> waiter : waiters)
+            waiter.resume();
+    }
+
+private:
+    std::mutex mutex_;
+    bool fired_ = false;
+    std::vector<std::coroutine_handle<>> waiters_;
+};
+
+// 立即开始执行、结束后自行销毁的顶层协程，用来从普通函数里启动FTask
+struct Detached {
+    struct promise_type {
+        Detached get_return_object(){return {};}
+        std::suspend_never initial_suspend() noexcept {return {};}
+        std::suspend_never final_suspend() noexcept {return {};}
+        void return_void(){}
+        void unhandled_exception(){ std::terminate(); }
+    };
+};
+
+static std::atomic<int> backendCalls(0);
+
+// 模拟慢速后端：等事件触发后才返回
+static FTask<std::string> fetchFromBackend(Event& ready, int key, bool fail){
+    Event& event = ready;
+    co_await event;
+    backendCalls++;
+    if(fail) throw std::runtime_error("backend unavailable");
+    co_return "value" + std::to_string(key);
+}
+
+static Detached reader(FulinCache::FAsyncCache<int, std::string>& cache, int key, Event& ready, bool fail,
+                       std::vector<std::string>& results, std::mutex& resultsMutex){
+    std::string result;
+    try{
+        result = co_await cache.loadAsync(key, [&ready, key, fail]{ return fetchFromBackend(ready, key, fail); });
+    }catch(const std::runtime_error&){
+        result = "error";
+    }
+    std::lock_guard<std::mutex> lock(resultsMutex);
+    results.push_back(result);
+}
+
+static bool check(bool condition, const char* what){
+    if(!condition) std::cerr << "失败: " << what << std::endl;
+    return condition;
+}
+
+int main(){
+    const int READERS = 8;
+    FulinCache::FLruCache<int, std::string> lru(16);
+    FulinCache::FAsyncCache<int, std::string> cache(lru);
+    std::vector<std::string> results;
+    std::mutex resultsMutex;
+    bool ok = true;
+
+    // 八个协程同时未命中同一个key，loader在工作线程上完成
+    Event ready;
+    for(int i = 0; i < READERS; ++i)
+        reader(cache, 1, ready, false, results, resultsMutex);
+    ok &= check(results.empty(), "加载完成前不应有协程返回");
+    std::thread worker([&ready]{ ready.fire(); });
+    worker.join();
+    ok &= check(backendCalls == 1, "同一个key只应调用一次后端");
+    ok &= check(results.size() == READERS, "所有等待者都应恢复");
+    for(const std::string& result : results)
+        ok &= check(result == "value1", "等待者应拿到同一个结果");
+    std::string cached;
+    ok &= check(lru.get(1, cached) && cached == "value1", "结果应写入缓存");
+
+    // 之后的请求直接命中缓存，不再调用后端
+    results.clear();
+    reader(cache, 1, ready, false, results, resultsMutex);
+    ok &= check(results.size() == 1 && backendCalls == 1, "命中缓存时不应调用后端");
+
+    // loader失败时异常传给所有等待者，结果不写入缓存
+    Event failing;
+    results.clear();
+    for(int i = 0; i < READERS; ++i)
+        reader(cache, 2, failing, true, results, resultsMutex);
+    failing.fire();
+    ok &= check(results.size() == READERS && results.front() == "error" && results.back() == "error",
+                "异常应传给所有等待者");
+    ok &= check(!lru.get(2, cached), "失败的结果不应写入缓存");
+
+    std::cout << (ok ? "FAsyncCache示例通过" : "FAsyncCache示例失败") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -1,28 +1,26 @@
 #include <iostream>
 #include <random>
 #include <iomanip>
+#include <array>
+#include <vector>
 #include "FLfuCache.h"
 #include "FLruCache.h"
 #include "FArcCache/FArcCache.h"
+#include "FClockCache.h"
+#include "FTinyLfuCache.h"
+#ifdef _WIN32
 #include <windows.h>
 #include <io.h>
+#endif
 
 
 void printResults(const std::string& testName, int capacity,
                   const std::vector<int>& get_operations,
-                  const std::vector<int>& hits){
+                  const std::vector<int>& hits,
+                  const std::vector<std::string>& names){
     std::cout <<"===" << testName <<"结果汇总==="<<std::endl;
     std::cout<<"缓存大小:" << capacity << std::endl;
 
-    std::vector<std::string> names;
-    if(hits.size() == 3){
-        names = {"LRU", "LFU", "ARC"};
-    }else if(hits.size() == 4){
-        names = {"LRU", "LFU", "ARC", "LRU-K"};
-    }else if(hits.size() == 5){
-        names = {"LRU", "LFU", "ARC", "LRU-K", "LFU-Aging"};
-    }
-
     for(size_t i =0; i < hits.size(); ++i){
         double hitRate = 100.0 * hits[i] / get_operations[i];
         std::cout << (i < names.size()? names[i] : "Algorithm" + std::to_string(i + 1))
@@ -43,14 +41,17 @@ void testHotDataAccess(){
     FulinCache::FLruCache<int, std::string> lru(CAPACITY);
     FulinCache::FLfuCache<int, std::string> lfu(CAPACITY);
     FulinCache::ArcCache<int, std::string> arc(CAPACITY);
+    FulinCache::FLruKCache<int, std::string> lruk(CAPACITY, HOT_KEYS + COLD_KEYS, 2);
+    FulinCache::FClockCache<int, std::string> clock(CAPACITY);
+    FulinCache::FTinyLfuCache<int, std::string> tinyLfu(CAPACITY);
 
     std::random_device rd;
     std::mt19937 gen(rd());
 
-    std::array<FulinCache::FICachePolicy<int, std::string>*, 3> caches = {&lru, &lfu,  &arc};
-    std::vector<int> hits(3, 0);
-    std::vector<int> get_operations(3, 0);
-    std::vector<std::string> names={"LRU", "LFU", "ARC"};
+    std::array<FulinCache::FICachePolicy<int, std::string>*, 6> caches = {&lru, &lfu,  &arc, &lruk, &clock, &tinyLfu};
+    std::vector<int> hits(6, 0);
+    std::vector<int> get_operations(6, 0);
+    std::vector<std::string> names={"LRU", "LFU", "ARC", "LRU-K", "CLOCK", "W-TinyLFU"};
 
     for (int i = 0; i < caches.size(); ++i) {
         for (int key = 0; key < HOT_KEYS; ++key) {
@@ -79,7 +80,7 @@ void testHotDataAccess(){
             }
         }
     }
-    printResults("工作负载剧烈变化测试", CAPACITY, get_operations, hits);
+    printResults("工作负载剧烈变化测试", CAPACITY, get_operations, hits, names);
 }
 
 void testLoopPattern() {
@@ -92,14 +93,17 @@ void testLoopPattern() {
     FulinCache::FLruCache<int, std::string> lru(CAPACITY);
     FulinCache::FLfuCache<int, std::string> lfu(CAPACITY);
     FulinCache::ArcCache<int, std::string> arc(CAPACITY);
+    FulinCache::FLruKCache<int, std::string> lruk(CAPACITY, LOOP_SIZE * 2, 2);
+    FulinCache::FClockCache<int, std::string> clock(CAPACITY);
+    FulinCache::FTinyLfuCache<int, std::string> tinyLfu(CAPACITY);
 
     std::random_device rd;
     std::mt19937 gen(rd());
 
-    std::array<FulinCache::FICachePolicy<int, std::string>*, 3> caches = {&lru, &lfu,  &arc};
-    std::vector<int> hits(3, 0);
-    std::vector<int> get_operations(3, 0);
-    std::vector<std::string> names={"LRU", "LFU", "ARC"};
+    std::array<FulinCache::FICachePolicy<int, std::string>*, 6> caches = {&lru, &lfu,  &arc, &lruk, &clock, &tinyLfu};
+    std::vector<int> hits(6, 0);
+    std::vector<int> get_operations(6, 0);
+    std::vector<std::string> names={"LRU", "LFU", "ARC", "LRU-K", "CLOCK", "W-TinyLFU"};
 
     for (int i = 0; i < caches.size(); ++i) {
         for (int key = 0; key < LOOP_SIZE / 5; ++key) {
@@ -130,7 +134,7 @@ void testLoopPattern() {
             }
         }
     }
-    printResults("循环扫描测试",CAPACITY,get_operations,hits);
+    printResults("循环扫描测试",CAPACITY,get_operations,hits,names);
 }
 
 void testWorkloadShift(){
@@ -142,14 +146,17 @@ void testWorkloadShift(){
     FulinCache::FLruCache<int, std::string> lru(CAPACITY);
     FulinCache::FLfuCache<int, std::string> lfu(CAPACITY);
     FulinCache::ArcCache<int, std::string> arc(CAPACITY);
+    FulinCache::FLruKCache<int, std::string> lruk(CAPACITY, 500, 2);
+    FulinCache::FClockCache<int, std::string> clock(CAPACITY);
+    FulinCache::FTinyLfuCache<int, std::string> tinyLfu(CAPACITY);
 
     std::random_device rd;
     std::mt19937 gen(rd());
 
-    std::array<FulinCache::FICachePolicy<int, std::string>*, 3> caches = {&lru, &lfu,  &arc};
-    std::vector<int> hits(3, 0);
-    std::vector<int> get_operations(3, 0);
-    std::vector<std::string> names={"LRU", "LFU", "ARC"};
+    std::array<FulinCache::FICachePolicy<int, std::string>*, 6> caches = {&lru, &lfu,  &arc, &lruk, &clock, &tinyLfu};
+    std::vector<int> hits(6, 0);
+    std::vector<int> get_operations(6, 0);
+    std::vector<std::string> names={"LRU", "LFU", "ARC", "LRU-K", "CLOCK", "W-TinyLFU"};
 
 
     // 为每种缓存算法运行相同的测试
@@ -217,11 +224,13 @@ void testWorkloadShift(){
         }
     }
 
-    printResults("工作负载剧烈变化测试", CAPACITY, get_operations, hits);
+    printResults("工作负载剧烈变化测试", CAPACITY, get_operations, hits, names);
 }
 
 int main() {
+#ifdef _WIN32
     SetConsoleOutputCP(CP_UTF8);
+#endif
     testHotDataAccess();
     testLoopPattern();
     testWorkloadShift();
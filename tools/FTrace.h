@@ -0,0 +1,331 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+
+#ifndef FULINCACHE_FTRACE_H
+#define FULINCACHE_FTRACE_H
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "../FICachePolicy.h"
+#include "../FSpan.h"
+
+namespace FulinCache {
+    enum class FTraceOp : uint8_t {
+        Get = 0, // 读，未命中时按需回填
+        Put = 1  // 写，直接覆盖
+    };
+
+    // 二进制trace的一条记录，按本机字节序存储。key为原始key的64位哈希（或本身就是整数key），
+    // size为对象字节数，未知时为0
+    struct FTraceRecord {
+        uint64_t key;
+        uint32_t size;
+        uint8_t op;
+        uint8_t reserved[3];
+    };
+
+    static_assert(sizeof(FTraceRecord) == 16, "FTraceRecord必须是16字节，二进制trace直接映射为记录数组");
+
+    // 二进制trace文件头：8字节magic，后接记录条数，之后紧跟记录
+    struct FTraceHeader {
+        char magic[8];
+        uint64_t count;
+    };
+
+    constexpr char kTraceMagic[8] = {'F', 'T', 'R', 'A', 'C', 'E', '0', '1'};
+
+    // 只读映射整个文件。Windows下退化为一次性读入内存
+    class FMappedFile {
+    public:
+        FMappedFile() = default;
+        FMappedFile(const FMappedFile&) = delete;
+        FMappedFile& operator=(const FMappedFile&) = delete;
+
+        ~FMappedFile(){
+#ifndef _WIN32
+            if(mapped_ && size_) munmap(mapped_, size_);
+#endif
+        }
+
+        bool open(const std::string& path){
+#ifdef _WIN32
+            std::ifstream in(path, std::ios::binary);
+            if(!in) return false;
+            buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            data_ = buffer_.data();
+            size_ = buffer_.size();
+            return true;
+#else
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if(fd < 0) return false;
+            struct stat st;
+            if(fstat(fd, &st) != 0){
+                ::close(fd);
+                return false;
+            }
+            size_ = static_cast<size_t>(st.st_size);
+            if(size_ > 0){
+                mapped_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if(mapped_ == MAP_FAILED){
+                    mapped_ = nullptr;
+                    size_ = 0;
+                    ::close(fd);
+                    return false;
+                }
+                // trace只顺序读一遍，提示内核积极预读
+                madvise(mapped_, size_, MADV_SEQUENTIAL);
+                data_ = static_cast<const char*>(mapped_);
+            }
+            ::close(fd);
+            return true;
+#endif
+        }
+
+        const char* data() const {return data_;}
+        size_t size() const {return size_;}
+
+    private:
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+#ifdef _WIN32
+        std::vector<char> buffer_;
+#else
+        void* mapped_ = nullptr;
+#endif
+    };
+
+    // 与平台无关的64位FNV-1a，把非数字key映射为trace中的key，同一份日志在各平台上转换结果一致
+    inline uint64_t traceKeyHash(std::string_view key){
+        uint64_t hash = 14695981039346656037ull;
+        for(char c : key){
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // 一份加载好的trace。二进制格式直接引用映射的内存，文本格式解析为records_
+    class FTrace {
+    public:
+        // format取bin、arc、csv或auto（按文件头magic识别二进制，扩展名.csv为csv，否则按arc解析）。
+        // 文本格式：
+        //   arc：ARC论文/OLTP trace的"起始块 块数 忽略 请求号"，展开为块数个连续块的读请求
+        //   csv：每行"key"、"key,size"或"op,key[,size]"，op为get/read/r或set/put/write/w；
+        //        纯数字key原样使用，其余按traceKeyHash取哈希；#开头的行和包含key列名的首行跳过
+        // 失败时返回false并在error中说明原因
+        bool load(const std::string& path, std::string format, std::string& error){
+            if(!file_.open(path)){
+                error = "无法打开" + path;
+                return false;
+            }
+            std::string_view text(file_.data(), file_.size());
+            bool isBinary = text.size() >= sizeof(FTraceHeader) &&
+                            std::memcmp(text.data(), kTraceMagic, sizeof(kTraceMagic)) == 0;
+            if(format == "auto"){
+                if(isBinary) format = "bin";
+                else if(path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0) format = "csv";
+                else format = "arc";
+            }
+            if(format == "bin"){
+                if(!isBinary){
+                    error = path + "不是二进制trace（magic不符）";
+                    return false;
+                }
+                FTraceHeader header;
+                std::memcpy(&header, text.data(), sizeof(header));
+                if(header.count > (text.size() - sizeof(FTraceHeader)) / sizeof(FTraceRecord)){
+                    error = path + "已截断：文件头记录数超出文件长度";
+                    return false;
+                }
+                // mmap返回页对齐地址，文件头为16字节，记录数组天然按8字节对齐
+                mapped_ = FSpan<const FTraceRecord>(
+                        reinterpret_cast<const FTraceRecord*>(text.data() + sizeof(FTraceHeader)),
+                        static_cast<size_t>(header.count));
+                return true;
+            }
+            if(format == "arc") parseArc(text);
+            else if(format == "csv") parseCsv(text);
+            else{
+                error = "未知的trace格式: " + format;
+                return false;
+            }
+            mapped_ = FSpan<const FTraceRecord>(records_.data(), records_.size());
+            return true;
+        }
+
+        FSpan<const FTraceRecord> records() const {return mapped_;}
+
+        // 把任意格式加载出的记录写为二进制trace，之后重放可直接映射，省去文本解析
+        static bool save(const std::string& path, FSpan<const FTraceRecord> records){
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            if(!out) return false;
+            FTraceHeader header;
+            std::memcpy(header.magic, kTraceMagic, sizeof(kTraceMagic));
+            header.count = records.size();
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(records.data()),
+                      static_cast<std::streamsize>(records.size() * sizeof(FTraceRecord)));
+            return static_cast<bool>(out);
+        }
+
+    private:
+        static FTraceRecord makeRecord(uint64_t key, uint32_t size, FTraceOp op){
+            FTraceRecord record{};
+            record.key = key;
+            record.size = size;
+            record.op = static_cast<uint8_t>(op);
+            return record;
+        }
+
+        static bool parseNumber(std::string_view field, uint64_t& value){
+            if(field.empty()) return false;
+            value = 0;
+            for(char c : field){
+                if(c < '0' || c > '9') return false;
+                value = value * 10 + static_cast<uint64_t>(c - '0');
+            }
+            return true;
+        }
+
+        static std::string_view trim(std::string_view s){
+            while(!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+            while(!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+            return s;
+        }
+
+        template<typename Fn>
+        static void forEachLine(std::string_view text, Fn&& fn){
+            while(!text.empty()){
+                size_t end = text.find('\n');
+                std::string_view line = trim(text.substr(0, end));
+                text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+                if(!line.empty() && line.front() != '#')
+                    fn(line);
+            }
+        }
+
+        void parseArc(std::string_view text){
+            forEachLine(text, [this](std::string_view line){
+                uint64_t fields[2];
+                for(uint64_t& field : fields){
+                    size_t end = line.find_first_of(" \t");
+                    if(!parseNumber(line.substr(0, end), field)) return;
+                    line = trim(line.substr(end == std::string_view::npos ? line.size() : end));
+                }
+                for(uint64_t block = 0; block < fields[1]; ++block)
+                    records_.push_back(makeRecord(fields[0] + block, 0, FTraceOp::Get));
+            });
+        }
+
+        void parseCsv(std::string_view text){
+            bool firstLine = true;
+            forEachLine(text, [this, &firstLine](std::string_view line){
+                std::string_view fields[3];
+                size_t count = 0;
+                while(count < 3){
+                    size_t comma = line.find(',');
+                    fields[count++] = trim(line.substr(0, comma));
+                    if(comma == std::string_view::npos) break;
+                    line.remove_prefix(comma + 1);
+                }
+                bool header = firstLine;
+                firstLine = false;
+                if(header)
+                    for(size_t i = 0; i < count; ++i)
+                        if(fields[i] == "key") return;
+
+                FTraceOp op = FTraceOp::Get;
+                size_t keyField = 0;
+                std::string_view first = fields[0];
+                if(count >= 2){
+                    if(first == "get" || first == "GET" || first == "read" || first == "r" || first == "R"){
+                        keyField = 1;
+                    }else if(first == "set" || first == "SET" || first == "put" || first == "PUT" ||
+                             first == "write" || first == "w" || first == "W"){
+                        op = FTraceOp::Put;
+                        keyField = 1;
+                    }
+                }
+                if(keyField >= count || fields[keyField].empty()) return;
+                uint64_t key;
+                if(!parseNumber(fields[keyField], key))
+                    key = traceKeyHash(fields[keyField]);
+                uint64_t size = 0;
+                if(keyField + 1 < count && !parseNumber(fields[keyField + 1], size)) return;
+                records_.push_back(makeRecord(key, static_cast<uint32_t>(std::min<uint64_t>(size, UINT32_MAX)), op));
+            });
+        }
+
+        FMappedFile file_;
+        std::vector<FTraceRecord> records_;
+        FSpan<const FTraceRecord> mapped_;
+    };
+
+    struct FReplayResult {
+        uint64_t gets = 0;       // 计入统计的读请求
+        uint64_t hits = 0;
+        uint64_t puts = 0;       // 计入统计的写请求
+        uint64_t getBytes = 0;   // 读请求的对象字节数之和，trace不带size时为0
+        uint64_t hitBytes = 0;
+        double seconds = 0;      // 整段重放（含预热）耗时
+
+        double hitRatio() const{
+            return gets ? static_cast<double>(hits) / static_cast<double>(gets) : 0.0;
+        }
+
+        double byteHitRatio() const{
+            return getBytes ? static_cast<double>(hitBytes) / static_cast<double>(getBytes) : 0.0;
+        }
+    };
+
+    // 单线程全速重放：读请求未命中时以对象大小为value回填，写请求直接put。
+    // 前warmup条记录只用来填充缓存，不计入命中率
+    inline FReplayResult replayTrace(FICachePolicy<uint64_t, uint32_t>& cache,
+                                     FSpan<const FTraceRecord> records, size_t warmup = 0){
+        FReplayResult result;
+        uint32_t value = 0;
+        auto begin = std::chrono::steady_clock::now();
+        for(size_t i = 0; i < records.size(); ++i){
+            const FTraceRecord& record = records[i];
+            bool counted = i >= warmup;
+            if(record.op == static_cast<uint8_t>(FTraceOp::Put)){
+                cache.put(record.key, record.size);
+                if(counted) result.puts++;
+                continue;
+            }
+            bool hit = cache.get(record.key, value);
+            if(!hit)
+                cache.put(record.key, record.size);
+            if(counted){
+                result.gets++;
+                result.getBytes += record.size;
+                if(hit){
+                    result.hits++;
+                    result.hitBytes += record.size;
+                }
+            }
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        return result;
+    }
+
+} // FulinCache
+
+#endif //FULINCACHE_FTRACE_H
@@ -0,0 +1,167 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+// 一遍扫描trace求LRU的未命中率曲线，代替在几十个容量上分别重放。
+// 用法: FTraceMrc <trace> [--format=auto|bin|arc|csv] [--rate=R] [--max-keys=N] [--bucket=W]
+//                 [--capacity=N[,N...]] [--points=N] [--verify] [--output=table|json|csv]
+// trace中的每条记录（读和写）都算一次访问。--rate为SHARDS固定采样率，--max-keys为固定内存采样
+// 最多跟踪的key数，--bucket为距离直方图的桶宽；未给--capacity时在曲线范围内按对数间隔取--points个容量（默认20）。
+// --verify在同样的容量上用FLruCache实际重放一遍，对照给出模拟的未命中率。
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "FTrace.h"
+#include "../FLruCache.h"
+#include "../FMissRatioCurve.h"
+
+using BenchClock = std::chrono::steady_clock;
+
+struct Options {
+    std::string path;
+    std::string format = "auto";
+    double rate = 1.0;
+    size_t maxKeys = 0;
+    size_t bucket = 1;
+    std::vector<size_t> capacities;
+    size_t points = 20;
+    bool verify = false;
+    std::string output = "table";
+};
+
+static std::vector<std::string> split(const std::string& list){
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while(std::getline(stream, item, ','))
+        if(!item.empty()) items.push_back(item);
+    return items;
+}
+
+static void usage(){
+    std::cerr << "用法: FTraceMrc <trace> [--format=auto|bin|arc|csv] [--rate=R] [--max-keys=N] [--bucket=W] "
+                 "[--capacity=N[,N...]] [--points=N] [--verify] [--output=table|json|csv]" << std::endl;
+    std::exit(1);
+}
+
+static Options parse(int argc, char* argv[]){
+    Options options;
+    for(int i = 1; i < argc; ++i){
+        std::string arg = argv[i];
+        if(arg.compare(0, 2, "--") != 0){
+            if(!options.path.empty()) usage();
+            options.path = arg;
+            continue;
+        }
+        size_t eq = arg.find('=');
+        std::string name = arg.substr(0, eq);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+        if(name == "--format") options.format = value;
+        else if(name == "--rate") options.rate = std::stod(value);
+        else if(name == "--max-keys") options.maxKeys = std::stoul(value);
+        else if(name == "--bucket") options.bucket = std::max<size_t>(std::stoul(value), 1);
+        else if(name == "--capacity"){
+            for(const std::string& item : split(value))
+                options.capacities.push_back(std::max<size_t>(std::stoul(item), 1));
+        }
+        else if(name == "--points") options.points = std::max<size_t>(std::stoul(value), 2);
+        else if(name == "--verify") options.verify = true;
+        else if(name == "--output") options.output = value;
+        else{
+            std::cerr << "未知参数: " << arg << std::endl;
+            usage();
+        }
+    }
+    if(options.path.empty()) usage();
+    if(options.rate <= 0 || options.rate > 1){
+        std::cerr << "--rate须在(0, 1]内" << std::endl;
+        std::exit(1);
+    }
+    if(options.output != "table" && options.output != "json" && options.output != "csv"){
+        std::cerr << "--output只支持table、json、csv" << std::endl;
+        std::exit(1);
+    }
+    return options;
+}
+
+// 与曲线口径一致：每条记录先get，未命中再put
+static double simulateLru(FulinCache::FSpan<const FulinCache::FTraceRecord> records, size_t capacity){
+    FulinCache::FLruCache<uint64_t, uint32_t> cache(capacity);
+    uint32_t value = 0;
+    uint64_t misses = 0;
+    for(const FulinCache::FTraceRecord& record : records){
+        if(!cache.get(record.key, value)){
+            misses++;
+            cache.put(record.key, record.size);
+        }
+    }
+    return records.size() ? static_cast<double>(misses) / static_cast<double>(records.size()) : 0.0;
+}
+
+int main(int argc, char* argv[]){
+    Options options = parse(argc, argv);
+
+    FulinCache::FTrace trace;
+    std::string error;
+    if(!trace.load(options.path, options.format, error)){
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    FulinCache::FSpan<const FulinCache::FTraceRecord> records = trace.records();
+
+    FulinCache::FMissRatioCurve<uint64_t> mrc(options.rate, options.maxKeys, options.bucket);
+    BenchClock::time_point begin = BenchClock::now();
+    for(const FulinCache::FTraceRecord& record : records)
+        mrc.access(record.key);
+    double seconds = std::chrono::duration<double>(BenchClock::now() - begin).count();
+    std::vector<FulinCache::FMrcPoint> curve = mrc.curve();
+    std::cerr << options.path << ": " << records.size() << "条请求, 最终采样率" << mrc.samplingRate()
+              << ", 耗时" << std::fixed << std::setprecision(3) << seconds << "s" << std::endl;
+
+    if(options.capacities.empty()){
+        size_t largest = curve.empty() ? 1 : curve.back().capacity;
+        double step = std::pow(static_cast<double>(largest), 1.0 / static_cast<double>(options.points - 1));
+        double capacity = 1;
+        for(size_t i = 0; i < options.points; ++i, capacity *= step){
+            size_t rounded = std::max<size_t>(static_cast<size_t>(std::llround(capacity)), 1);
+            if(options.capacities.empty() || rounded > options.capacities.back())
+                options.capacities.push_back(rounded);
+        }
+    }
+
+    if(options.output == "csv")
+        std::cout << "capacity,miss_ratio" << (options.verify ? ",lru_miss_ratio" : "") << '\n';
+    else if(options.output == "json")
+        std::cout << "[\n";
+    else
+        std::cout << std::right << std::setw(12) << "capacity" << std::setw(12) << "miss"
+                  << (options.verify ? "    LRU miss" : "") << '\n';
+
+    for(size_t i = 0; i < options.capacities.size(); ++i){
+        size_t capacity = options.capacities[i];
+        double missRatio = mrc.missRatio(capacity);
+        double lruMissRatio = options.verify ? simulateLru(records, capacity) : 0.0;
+        if(options.output == "csv"){
+            std::cout << capacity << ',' << std::fixed << std::setprecision(6) << missRatio;
+            if(options.verify) std::cout << ',' << lruMissRatio;
+            std::cout << '\n';
+        }else if(options.output == "json"){
+            std::cout << (i == 0 ? "  " : ",\n  ") << "{\"capacity\":" << capacity
+                      << std::fixed << std::setprecision(6) << ",\"miss_ratio\":" << missRatio;
+            if(options.verify) std::cout << ",\"lru_miss_ratio\":" << lruMissRatio;
+            std::cout << "}";
+        }else{
+            std::cout << std::setw(12) << capacity << std::fixed << std::setprecision(2) << std::setw(11) << missRatio * 100 << '%';
+            if(options.verify) std::cout << std::setw(11) << lruMissRatio * 100 << '%';
+            std::cout << '\n';
+        }
+    }
+    if(options.output == "json")
+        std::cout << "\n]\n";
+    return 0;
+}
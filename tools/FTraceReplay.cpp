@@ -0,0 +1,240 @@
+//
+// Created by huoqi on 2026/10/17.
+//
+// 用真实访问日志重放各缓存策略，报告命中率与吞吐，据此挑选策略和容量。
+// 用法: FTraceReplay <trace> [--format=auto|bin|arc|csv] [--capacity=N[,N...]] [--policies=a,b]
+//                    [--weighted] [--warmup=N] [--output=table|json|csv] [--convert=out.ftrace]
+// trace格式见tools/FTrace.h。--capacity可给多个值，依次重放以比较不同容量；
+// --weighted时以对象字节数为权重，capacity按字节计，只对支持weigher的策略生效，默认容量取所有不同对象总字节数的比例；
+// 此时HashLFU使用全局容量，HashLRU仍按分片切分字节预算，大于单个分片预算的对象不会被缓存，运行时会给出提示；
+// --warmup为不计入命中率的前N条记录；--convert把文本trace转成可直接mmap的二进制格式后退出。
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "FTrace.h"
+#include "../FLruCache.h"
+#include "../FLfuCache.h"
+#include "../FArcCache/FArcCache.h"
+#include "../FClockCache.h"
+#include "../FTinyLfuCache.h"
+
+using Cache = FulinCache::FICachePolicy<uint64_t, uint32_t>;
+using Weigher = FulinCache::FWeigher<uint64_t, uint32_t>;
+
+struct Options {
+    std::string path;
+    std::string format = "auto";
+    std::vector<size_t> capacities;
+    std::vector<std::string> policies;
+    bool weighted = false;
+    size_t warmup = 0;
+    std::string output = "table";
+    std::string convert;
+};
+
+struct Policy {
+    std::string name;
+    bool supportsWeight;
+    // 参数依次为容量、trace中不同key的个数（LRU-K的历史容量）、weigher
+    std::function<std::unique_ptr<Cache>(size_t, size_t, Weigher)> make;
+};
+
+// 与分片缓存的默认分片数一致：硬件线程数，且不超过容量
+static size_t sliceCount(size_t capacity){
+    size_t slices = std::max(1u, std::thread::hardware_concurrency());
+    return std::max<size_t>(std::min(slices, capacity), 1);
+}
+
+static std::vector<Policy> allPolicies(){
+    using namespace FulinCache;
+    return {
+        {"LRU", true, [](size_t capacity, size_t, Weigher weigher){
+            return std::unique_ptr<Cache>(new FLruCache<uint64_t, uint32_t>(capacity, false, weigher)); }},
+        {"LFU", true, [](size_t capacity, size_t, Weigher weigher){
+            return std::unique_ptr<Cache>(new FLfuCache<uint64_t, uint32_t>(capacity, 10, weigher)); }},
+        {"ARC", true, [](size_t capacity, size_t, Weigher weigher){
+            return std::unique_ptr<Cache>(new ArcCache<uint64_t, uint32_t>(capacity, 2, weigher)); }},
+        {"LRU-K", true, [](size_t capacity, size_t keys, Weigher weigher){
+            return std::unique_ptr<Cache>(new FLruKCache<uint64_t, uint32_t>(capacity, keys, 2, weigher)); }},
+        {"CLOCK", false, [](size_t capacity, size_t, Weigher){
+            return std::unique_ptr<Cache>(new FClockCache<uint64_t, uint32_t>(capacity)); }},
+        {"W-TinyLFU", false, [](size_t capacity, size_t, Weigher){
+            return std::unique_ptr<Cache>(new FTinyLfuCache<uint64_t, uint32_t>(capacity)); }},
+        {"HashLRU", true, [](size_t capacity, size_t, Weigher weigher){
+            return std::unique_ptr<Cache>(new FHashLruCache<uint64_t, uint32_t>(capacity, sliceCount(capacity), false, weigher)); }},
+        // 按字节计容量时用全局容量，避免大对象因超过capacity/分片数而永远无法缓存
+        {"HashLFU", true, [](size_t capacity, size_t, Weigher weigher){
+            return std::unique_ptr<Cache>(new FHashLfuCache<uint64_t, uint32_t>(capacity, 0, 10, static_cast<bool>(weigher), weigher)); }},
+    };
+}
+
+static std::vector<std::string> split(const std::string& list){
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while(std::getline(stream, item, ','))
+        if(!item.empty()) items.push_back(item);
+    return items;
+}
+
+static bool selected(const std::vector<std::string>& filter, const std::string& name){
+    return filter.empty() || std::find(filter.begin(), filter.end(), name) != filter.end();
+}
+
+static void usage(){
+    std::cerr << "用法: FTraceReplay <trace> [--format=auto|bin|arc|csv] [--capacity=N[,N...]] "
+                 "[--policies=a,b] [--weighted] [--warmup=N] [--output=table|json|csv] [--convert=out.ftrace]"
+              << std::endl;
+    std::exit(1);
+}
+
+static Options parse(int argc, char* argv[]){
+    Options options;
+    for(int i = 1; i < argc; ++i){
+        std::string arg = argv[i];
+        if(arg.compare(0, 2, "--") != 0){
+            if(!options.path.empty()) usage();
+            options.path = arg;
+            continue;
+        }
+        size_t eq = arg.find('=');
+        std::string name = arg.substr(0, eq);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+        if(name == "--format") options.format = value;
+        else if(name == "--capacity"){
+            for(const std::string& item : split(value))
+                options.capacities.push_back(std::max<size_t>(std::stoul(item), 1));
+        }
+        else if(name == "--policies") options.policies = split(value);
+        else if(name == "--weighted") options.weighted = true;
+        else if(name == "--warmup") options.warmup = std::stoul(value);
+        else if(name == "--output") options.output = value;
+        else if(name == "--convert") options.convert = value;
+        else{
+            std::cerr << "未知参数: " << arg << std::endl;
+            usage();
+        }
+    }
+    if(options.path.empty()) usage();
+    if(options.output != "table" && options.output != "json" && options.output != "csv"){
+        std::cerr << "--output只支持table、json、csv" << std::endl;
+        std::exit(1);
+    }
+    return options;
+}
+
+static void printRow(const Options& options, const std::string& policy, size_t capacity,
+                     const FulinCache::FReplayResult& r, bool first){
+    double requests = static_cast<double>(r.gets + r.puts);
+    double opsPerSecond = r.seconds > 0 ? requests / r.seconds : 0.0;
+    if(options.output == "csv"){
+        std::cout << policy << ',' << capacity << ',' << r.gets << ',' << r.hits << ',' << r.puts << ','
+                  << std::fixed << std::setprecision(6) << r.hitRatio() << ',' << r.byteHitRatio() << ','
+                  << r.seconds << ',' << std::setprecision(0) << opsPerSecond << '\n';
+    }else if(options.output == "json"){
+        std::cout << (first ? "  " : ",\n  ")
+                  << "{\"policy\":\"" << policy << "\",\"capacity\":" << capacity
+                  << ",\"gets\":" << r.gets << ",\"hits\":" << r.hits << ",\"puts\":" << r.puts
+                  << std::fixed << std::setprecision(6) << ",\"hit_ratio\":" << r.hitRatio()
+                  << ",\"byte_hit_ratio\":" << r.byteHitRatio() << ",\"seconds\":" << r.seconds
+                  << std::setprecision(0) << ",\"ops_per_sec\":" << opsPerSecond << "}";
+    }else{
+        std::cout << std::left << std::setw(11) << policy
+                  << std::right << std::setw(12) << capacity
+                  << std::fixed << std::setprecision(2) << std::setw(9) << r.hitRatio() * 100 << '%'
+                  << std::setw(9) << r.byteHitRatio() * 100 << '%'
+                  << std::setprecision(0) << std::setw(14) << opsPerSecond << '\n';
+    }
+    std::cout.flush();
+}
+
+int main(int argc, char* argv[]){
+    Options options = parse(argc, argv);
+
+    FulinCache::FTrace trace;
+    std::string error;
+    if(!trace.load(options.path, options.format, error)){
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    FulinCache::FSpan<const FulinCache::FTraceRecord> records = trace.records();
+
+    if(!options.convert.empty()){
+        if(!FulinCache::FTrace::save(options.convert, records)){
+            std::cerr << "无法写入" << options.convert << std::endl;
+            return 1;
+        }
+        std::cerr << "已写入" << records.size() << "条记录到" << options.convert << std::endl;
+        return 0;
+    }
+
+    // 每个不同对象按最后一次出现的大小计
+    std::unordered_map<uint64_t, uint32_t> objectSizes;
+    for(const FulinCache::FTraceRecord& record : records)
+        objectSizes[record.key] = record.size;
+    uint64_t objectBytes = 0;
+    for(const auto& object : objectSizes)
+        objectBytes += object.second;
+    size_t keyCount = std::max<size_t>(objectSizes.size(), 1);
+    std::cerr << options.path << ": " << records.size() << "条请求, " << objectSizes.size() << "个不同key";
+    if(objectBytes) std::cerr << ", 不同对象共" << objectBytes << "字节";
+    std::cerr << std::endl;
+    if(options.weighted && objectBytes == 0){
+        std::cerr << "trace不带对象大小，无法使用--weighted" << std::endl;
+        return 1;
+    }
+
+    // 未指定容量时取不同key数（--weighted时为不同对象总字节数）的1%、5%、10%、25%
+    if(options.capacities.empty()){
+        uint64_t base = options.weighted ? objectBytes : keyCount;
+        for(uint64_t percent : {1, 5, 10, 25})
+            options.capacities.push_back(static_cast<size_t>(std::max<uint64_t>(base * percent / 100, 1)));
+    }
+
+    // HashLRU没有全局容量模式，字节预算按分片均分，超过单个分片预算的对象不会被缓存
+    if(options.weighted && selected(options.policies, "HashLRU")){
+        for(size_t capacity : options.capacities){
+            size_t sliceBudget = (capacity + sliceCount(capacity) - 1) / sliceCount(capacity);
+            size_t oversized = 0;
+            for(const auto& object : objectSizes)
+                if(object.second > sliceBudget) oversized++;
+            if(oversized)
+                std::cerr << "注意: 容量" << capacity << "时HashLRU每个分片只有" << sliceBudget << "字节，"
+                          << oversized << "个更大的对象永远不会被缓存" << std::endl;
+        }
+    }
+
+    Weigher weigher;
+    if(options.weighted)
+        weigher = [](const uint64_t&, const uint32_t& size){ return std::max<size_t>(size, 1); };
+
+    if(options.output == "csv")
+        std::cout << "policy,capacity,gets,hits,puts,hit_ratio,byte_hit_ratio,seconds,ops_per_sec\n";
+    else if(options.output == "json")
+        std::cout << "[\n";
+    else
+        std::cout << std::left << std::setw(11) << "policy" << std::right << std::setw(12) << "capacity"
+                  << std::setw(10) << "hit" << std::setw(10) << "byte hit" << std::setw(14) << "ops/s" << '\n';
+
+    bool first = true;
+    for(size_t capacity : options.capacities){
+        for(const Policy& policy : allPolicies()){
+            if(!selected(options.policies, policy.name)) continue;
+            if(options.weighted && !policy.supportsWeight) continue;
+            std::unique_ptr<Cache> cache = policy.make(capacity, keyCount, weigher);
+            printRow(options, policy.name, capacity, FulinCache::replayTrace(*cache, records, options.warmup), first);
+            first = false;
+        }
+    }
+    if(options.output == "json")
+        std::cout << "\n]\n";
+    return 0;
+}